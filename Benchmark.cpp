@@ -0,0 +1,630 @@
+//Benchmarks of the replay and CSF parsers over a synthetic corpus.
+//Like the command line tool, it only uses the portable parsers:
+//    g++ Benchmark.cpp -o ra3benchmark -O2 -Wall -std=c++17
+//    ./ra3benchmark [--quick] [--write-corpus <directory>] [--csf <file>]...
+//Real CSF files added by --csf are measured along with the synthetic ones.
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Input.hpp"
+#include "CSFParser.hpp"
+#include "ReplayParser.hpp"
+#include "BuiltinStrings.hpp"
+#include "SearchIndex.hpp"
+
+//Every allocation of the program is counted, so the memory used by a parser can be reported.
+//The size of an allocation is stored before the returned memory, to know how much is freed.
+namespace AllocationStatistics {
+	std::atomic<std::uint64_t> count{0};
+	std::atomic<std::size_t> current{0};
+	std::atomic<std::size_t> peak{0};
+	constexpr auto headerSize = alignof(std::max_align_t);
+}
+
+void* operator new(std::size_t size) {
+	using namespace AllocationStatistics;
+	auto memory = static_cast<char*>(std::malloc(size + headerSize));
+	if(memory == nullptr) {
+		throw std::bad_alloc{};
+	}
+	std::memcpy(memory, &size, sizeof(size));
+	++count;
+	auto now = current += size;
+	auto previousPeak = peak.load();
+	while(previousPeak < now and not peak.compare_exchange_weak(previousPeak, now)) { }
+	return memory + headerSize;
+}
+
+void operator delete(void* pointer) noexcept {
+	using namespace AllocationStatistics;
+	if(pointer == nullptr) {
+		return;
+	}
+	auto memory = static_cast<char*>(pointer) - headerSize;
+	auto size = std::size_t{};
+	std::memcpy(&size, memory, sizeof(size));
+	current -= size;
+	std::free(memory);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+namespace {
+	using namespace std::string_view_literals;
+
+	struct ReplayShape {
+		unsigned players;
+		std::uint32_t extraHeaderBytes; //bytes between the plain text and the first chunk, counted in header offset
+		std::size_t chunks;
+		std::size_t truncatedBytes;     //bytes cut from the end, 0 means a complete replay
+	};
+
+	struct CorpusFile {
+		std::string name;
+		std::vector<char> content;
+	};
+
+	template<typename T>
+	void appendBytes(std::vector<char>& buffer, const T& value) {
+		auto begin = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), begin, begin + sizeof(value));
+	}
+
+	void appendBytes(std::vector<char>& buffer, std::string_view bytes) {
+		buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+	}
+
+	void appendNullTerminatedWideString(std::vector<char>& buffer, std::u16string_view string) {
+		for(auto character : string) {
+			appendBytes(buffer, static_cast<std::uint16_t>(character));
+		}
+		appendBytes(buffer, std::uint16_t{0});
+	}
+
+	std::vector<char> generateReplay(const ReplayShape& shape, std::mt19937& random) {
+		auto replay = std::vector<char> {};
+		appendBytes(replay, ReplaysAndMods::replayHeaderMagic);
+		appendBytes(replay, "\x05"sv); //hNumber, player records have team numbers
+		for(auto version : {1u, 12u, 3u, 4u}) {
+			appendBytes(replay, std::uint32_t{version});
+		}
+		appendBytes(replay, "\x00\x00"sv);
+
+		appendNullTerminatedWideString(replay, u"Synthetic replay 游戏");
+		appendNullTerminatedWideString(replay, u"Generated by the benchmark");
+		appendNullTerminatedWideString(replay, u"data/maps/official/map_mp_2_feasel/map_mp_2_feasel.map");
+		appendNullTerminatedWideString(replay, u"map_mp_2_feasel");
+
+		appendBytes(replay, static_cast<std::uint8_t>(shape.players));
+		for(auto i = 0u; i < shape.players + 1; ++i) {
+			appendBytes(replay, std::uint32_t{i});
+			auto name = u"Player " + std::u16string(1, static_cast<char16_t>(u'A' + i % 26));
+			appendNullTerminatedWideString(replay, i == shape.players ? u"post Commentator" : name);
+			appendBytes(replay, static_cast<std::uint8_t>(i % 2));
+		}
+
+		constexpr auto cncMagic = "CNC3RPL\0"sv;
+		constexpr auto modInfo = "RA3\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0" "1.12"sv;
+		constexpr auto prePlainTextPadding = std::size_t{31};
+		auto plainText = std::string{"M=map_mp_2_feasel;MC=1F2E3D4C;S="};
+		for(auto i = 0u; i < shape.players; ++i) {
+			plainText += "HPlayer,1A2B3C4D,8088,TT,-1,-1,-1,-1,0,1,-1:";
+		}
+		plainText += "Hpost Commentator,0,0,TT,-1,-1,-1,-1,0,1,-1:;";
+
+		auto offset = cncMagic.size() + modInfo.size() + sizeof(std::uint32_t) + prePlainTextPadding
+		              + sizeof(std::uint32_t) + plainText.size() + shape.extraHeaderBytes;
+		appendBytes(replay, static_cast<std::uint32_t>(offset));
+		appendBytes(replay, static_cast<std::uint32_t>(cncMagic.size()));
+		appendBytes(replay, cncMagic);
+		appendBytes(replay, modInfo);
+		appendBytes(replay, std::uint32_t{1600000000});
+		replay.insert(replay.end(), prePlainTextPadding, '\0');
+		appendBytes(replay, static_cast<std::uint32_t>(plainText.size()));
+		appendBytes(replay, plainText);
+		replay.insert(replay.end(), shape.extraHeaderBytes, '\0');
+
+		auto chunkSize = std::uniform_int_distribution<std::uint32_t>{8, 96};
+		auto byte = std::uniform_int_distribution<int>{0, 255};
+		auto timeCode = std::uint32_t{0};
+		for(auto i = std::size_t{0}; i < shape.chunks; ++i) {
+			timeCode += 1 + (i % 3 == 0);
+			appendBytes(replay, timeCode);
+			appendBytes(replay, static_cast<std::uint8_t>(1 + i % 2));
+			auto size = chunkSize(random);
+			appendBytes(replay, size);
+			for(auto k = std::uint32_t{0}; k < size; ++k) {
+				replay.push_back(static_cast<char>(byte(random)));
+			}
+			appendBytes(replay, std::uint32_t{0});
+		}
+
+		auto lastTimeCode = std::array<char, sizeof(std::uint32_t)> {};
+		std::copy_n(reinterpret_cast<const char*>(&timeCode), sizeof(timeCode), lastTimeCode.begin());
+		ReplaysAndMods::writeReplayFooter(lastTimeCode, std::back_inserter(replay));
+
+		replay.resize(replay.size() - std::min(shape.truncatedBytes, replay.size()));
+		return replay;
+	}
+
+	std::vector<char> generateCSF(std::size_t stringCount, std::mt19937& random) {
+		auto strings = std::vector<std::pair<std::string, std::wstring>> {};
+		auto length = std::uniform_int_distribution<std::size_t>{4, 120};
+		auto character = std::uniform_int_distribution<int>{0x20, 0x7E};
+		auto cjk = std::uniform_int_distribution<int>{0x4E00, 0x9FA5};
+		for(auto i = std::size_t{0}; i < stringCount; ++i) {
+			auto label = "Category" + std::to_string(i % 64) + ":Label" + std::to_string(i);
+			auto text = std::wstring(length(random), L' ');
+			for(auto& wideChar : text) {
+				wideChar = static_cast<wchar_t>(i % 4 == 0 ? cjk(random) : character(random));
+			}
+			strings.emplace_back(std::move(label), std::move(text));
+		}
+
+		auto csf = std::vector<char> {};
+		MyCSF::writeCSF(Input::Range{strings.cbegin(), strings.cend()}, std::back_inserter(csf));
+		return csf;
+	}
+
+	//Null terminated UTF-16 strings, with lengths similar to titles, map names and player names
+	std::vector<char> generateWideStrings(std::size_t count, std::mt19937& random) {
+		auto strings = std::vector<char> {};
+		auto length = std::uniform_int_distribution<std::size_t>{4, 60};
+		auto character = std::uniform_int_distribution<int>{0x20, 0x9FA5};
+		for(auto i = std::size_t{0}; i < count; ++i) {
+			auto string = std::u16string(length(random), u' ');
+			for(auto& unit : string) {
+				unit = static_cast<char16_t>(character(random));
+			}
+			appendNullTerminatedWideString(strings, string);
+		}
+		return strings;
+	}
+
+	//Searchable fields of replays (name, title, map, mod, description and players), with random player names
+	std::vector<std::vector<std::wstring>> generateSearchDocuments(std::size_t count, std::mt19937& random) {
+		static constexpr auto maps = {L"map_mp_2_feasel", L"map_mp_4_rainer", L"map_mp_2_black_mesa", L"map_mp_6_ssmith"};
+		auto documents = std::vector<std::vector<std::wstring>> {};
+		auto nameLength = std::uniform_int_distribution<std::size_t>{3, 16};
+		auto character = std::uniform_int_distribution<int>{L'a', L'z'};
+		auto playerCount = std::uniform_int_distribution<std::size_t>{1, 6};
+		auto map = std::uniform_int_distribution<std::size_t>{0, maps.size() - 1};
+		for(auto i = std::size_t{0}; i < count; ++i) {
+			auto fields = std::vector<std::wstring>{L"Replay " + std::to_wstring(i), L"RA3 Match", std::begin(maps)[map(random)], L"RA3", L"Synthetic replay"};
+			for(auto players = playerCount(random); players > 0; --players) {
+				auto name = std::wstring(nameLength(random), L' ');
+				for(auto& unit : name) {
+					unit = static_cast<wchar_t>(character(random));
+				}
+				fields.push_back(std::move(name));
+			}
+			documents.push_back(std::move(fields));
+		}
+		return documents;
+	}
+
+	//Replays with different player counts, header offsets, chunk counts and truncation
+	std::vector<CorpusFile> generateReplayCorpus(bool quick, std::mt19937& random) {
+		auto corpus = std::vector<CorpusFile> {};
+		auto chunkCounts = quick ? std::vector<std::size_t>{100, 2000} : std::vector<std::size_t>{100, 2000, 20000, 100000};
+		for(auto chunks : chunkCounts) {
+			for(auto players : {1u, 2u, 4u, 6u}) {
+				for(auto extraHeaderBytes : {0u, 256u, 4096u}) {
+					for(auto truncatedBytes : {std::size_t{0}, std::size_t{7}, std::size_t{150}}) {
+						auto shape = ReplayShape{players, extraHeaderBytes, chunks, truncatedBytes};
+						auto name = "synthetic_" + std::to_string(chunks) + "chunks_" + std::to_string(players) + "players_"
+						            + std::to_string(extraHeaderBytes) + "offset_" + std::to_string(truncatedBytes) + "truncated.RA3Replay";
+						corpus.push_back(CorpusFile{std::move(name), generateReplay(shape, random)});
+					}
+				}
+			}
+		}
+		return corpus;
+	}
+
+	std::vector<CorpusFile> generateCSFCorpus(bool quick, std::mt19937& random) {
+		auto corpus = std::vector<CorpusFile> {};
+		auto stringCounts = quick ? std::vector<std::size_t>{100, 5000} : std::vector<std::size_t>{100, 5000, 50000, 100000, 200000};
+		for(auto stringCount : stringCounts) {
+			corpus.push_back(CorpusFile{"synthetic_" + std::to_string(stringCount) + "strings.csf", generateCSF(stringCount, random)});
+		}
+		return corpus;
+	}
+
+	void writeCorpus(const std::filesystem::path& directory, const std::vector<CorpusFile>& corpus) {
+		std::filesystem::create_directories(directory);
+		for(const auto& [name, content] : corpus) {
+			auto file = std::ofstream{directory / name, std::ios::binary};
+			file.write(content.data(), static_cast<std::streamsize>(content.size()));
+			if(not file) {
+				throw std::runtime_error("Cannot write " + (directory / name).string());
+			}
+		}
+	}
+
+	//Run the body until at least minimumTime has passed.
+	//body returns how many items and bytes it has processed in one run.
+	template<typename Body>
+	void runBenchmark(std::string_view name, std::chrono::duration<double> minimumTime, Body body) {
+		using Clock = std::chrono::steady_clock;
+		auto items = std::uint64_t{0};
+		auto bytes = std::uint64_t{0};
+		auto begin = Clock::now();
+		auto elapsed = std::chrono::duration<double>{};
+		do {
+			auto [runItems, runBytes] = body();
+			items += runItems;
+			bytes += runBytes;
+			elapsed = Clock::now() - begin;
+		}
+		while(elapsed < minimumTime);
+
+		auto seconds = elapsed.count();
+		std::cout << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(1)
+		          << std::setw(12) << bytes / (1024.0 * 1024.0) / seconds << " MB/s"
+		          << std::setw(16) << items / seconds << " items/s\n";
+	}
+
+	//Report how many allocations body makes, and the most memory it uses on top of what is already allocated
+	template<typename Body>
+	void measureMemory(std::string_view name, Body body) {
+		using namespace AllocationStatistics;
+		auto countBefore = count.load();
+		auto currentBefore = current.load();
+		peak = currentBefore;
+		body();
+		std::cout << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(1)
+		          << std::setw(12) << count.load() - countBefore << " allocations"
+		          << std::setw(12) << (peak.load() - currentBefore) / 1024.0 << " KB peak\n";
+	}
+
+	std::vector<char> readFile(const std::filesystem::path& path) {
+		auto file = std::ifstream{path, std::ios::binary};
+		if(not file) {
+			throw std::runtime_error("Cannot open " + path.string());
+		}
+		return std::vector<char>{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	}
+
+	Input::Range<const char*> asRange(const std::vector<char>& buffer) {
+		return Input::Range{buffer.data(), buffer.data() + buffer.size()};
+	}
+
+	Input::ContiguousReader asContiguousReader(const std::vector<char>& buffer) {
+		return Input::ContiguousReader{buffer.data(), buffer.data() + buffer.size()};
+	}
+
+	//Prevent the compiler from removing the work whose result is otherwise unused
+	volatile std::uint64_t blackHole = 0;
+}
+
+int main(int argc, char** argv) {
+	auto arguments = std::vector<std::string_view>(argv + std::min(argc, 1), argv + argc);
+	auto quick = std::find(arguments.begin(), arguments.end(), "--quick"sv) != arguments.end();
+	auto corpusDirectory = std::find(arguments.begin(), arguments.end(), "--write-corpus"sv);
+	constexpr auto usage = "Usage: ra3benchmark [--quick] [--write-corpus <directory>] [--csf <file>]...\n"sv;
+
+	auto random = std::mt19937{20180523};
+	auto replays = generateReplayCorpus(quick, random);
+	auto csfs = generateCSFCorpus(quick, random);
+	if(corpusDirectory != arguments.end()) {
+		if(std::next(corpusDirectory) == arguments.end()) {
+			std::cerr << usage;
+			return 2;
+		}
+		writeCorpus(std::filesystem::path{*std::next(corpusDirectory)}, replays);
+		writeCorpus(std::filesystem::path{*std::next(corpusDirectory)}, csfs);
+	}
+	for(auto argument = arguments.begin(); argument != arguments.end(); ++argument) {
+		if(*argument != "--csf"sv) {
+			continue;
+		}
+		if(++argument == arguments.end()) {
+			std::cerr << usage;
+			return 2;
+		}
+		auto path = std::filesystem::path{*argument};
+		csfs.push_back(CorpusFile{path.filename().string(), readFile(path)});
+	}
+
+	using namespace ReplaysAndMods;
+	const auto minimumTime = std::chrono::duration<double>{quick ? 0.1 : 1.0};
+	auto totalReplayBytes = std::uint64_t{0};
+	for(const auto& replay : replays) {
+		totalReplayBytes += replay.content.size();
+	}
+	std::cout << replays.size() << " replays (" << totalReplayBytes / (1024.0 * 1024.0) << " MB), "
+	          << csfs.size() << " CSF files\n";
+
+	//header parsing only touches the header, so its MB/s is counted over header bytes
+	auto wideStrings = generateWideStrings(10000, random);
+	auto scanWideStrings = [&wideStrings](auto findNull16) {
+		return [&wideStrings, findNull16] {
+			auto count = std::size_t{0};
+			const auto* end = wideStrings.data() + wideStrings.size();
+			for(const auto* current = wideStrings.data(); current != end; ++count) {
+				current = findNull16(current, end) + sizeof(std::uint16_t);
+			}
+			return std::pair{count, wideStrings.size()};
+		};
+	};
+	runBenchmark("findNull16Scalar", minimumTime, scanWideStrings(Input::findNull16Scalar));
+	runBenchmark("findNull16", minimumTime, scanWideStrings(Input::findNull16));
+
+	auto readWideStrings = [&wideStrings](auto makeReader) {
+		return [&wideStrings, makeReader] {
+			auto count = std::size_t{0};
+			auto reader = makeReader(wideStrings);
+			for(; reader.current != reader.end; ++count) {
+				blackHole += Internal::readNullTerminatedWideString(reader).size();
+			}
+			return std::pair{count, wideStrings.size()};
+		};
+	};
+	runBenchmark("readNullTerminatedWideString Range", minimumTime, readWideStrings(asRange));
+	runBenchmark("readNullTerminatedWideString ContiguousReader", minimumTime, readWideStrings(asContiguousReader));
+
+	auto parseHeaders = [&replays](auto makeReader) {
+		return [&replays, makeReader] {
+			auto bytes = std::uint64_t{0};
+			for(const auto& replay : replays) {
+				auto reader = makeReader(replay.content);
+				auto details = parseReplayHeader(reader);
+				blackHole += details.players.size();
+				bytes += static_cast<std::uint64_t>(reader.current - replay.content.data());
+			}
+			return std::pair{replays.size(), bytes};
+		};
+	};
+	runBenchmark("parseReplayHeader Range", minimumTime, parseHeaders(asRange));
+	runBenchmark("parseReplayHeader ContiguousReader", minimumTime, parseHeaders(asContiguousReader));
+
+	runBenchmark("getFinalTimeCodeFromLastBytes", minimumTime, [&replays] {
+		auto bytes = std::uint64_t{0};
+		for(const auto& replay : replays) {
+			auto begin = replay.content.data();
+			auto end = begin + replay.content.size();
+			auto footerLength = std::uint32_t{};
+			std::copy_n(end - sizeof(footerLength), sizeof(footerLength), reinterpret_cast<char*>(&footerLength));
+			auto lastBytesLength = std::min<std::uint64_t>(std::uint64_t{footerLength} + Internal::terminator.size(), replay.content.size());
+			blackHole += getFinalTimeCodeFromLastBytes(Input::Range{end - lastBytesLength, end}).value_or(0);
+			bytes += lastBytesLength;
+		}
+		return std::pair{replays.size(), bytes};
+	});
+
+	runBenchmark("probeReplay", minimumTime, [&replays] {
+		auto bytes = std::uint64_t{0};
+		for(const auto& replay : replays) {
+			auto begin = replay.content.data();
+			auto end = begin + replay.content.size();
+			auto headSize = std::min(replay.content.size(), replayProbeHeadSize);
+			auto tailSize = std::min(replay.content.size(), replayProbeTailSize);
+			auto state = probeReplay(Input::Range{begin, begin + headSize}, Input::Range{end - tailSize, end}, replay.content.size());
+			blackHole += state == ReplayState::valid;
+			bytes += headSize + tailSize;
+		}
+		return std::pair{replays.size(), bytes};
+	});
+
+	runBenchmark("fixReplay", minimumTime, [&replays, output = std::vector<char>{}]() mutable {
+		auto bytes = std::uint64_t{0};
+		for(const auto& replay : replays) {
+			output.clear();
+			fixReplay(Input::Range{replay.content.data(), replay.content.data() + replay.content.size()}, std::back_inserter(output));
+			blackHole += output.size();
+			bytes += replay.content.size();
+		}
+		return std::pair{replays.size(), bytes};
+	});
+
+	//the filter box of the Game Browser searches all replays again every time a character is typed
+	auto searchDocuments = generateSearchDocuments(20000, random);
+	runBenchmark("SearchIndex::add 20000 replays", minimumTime, [&searchDocuments] {
+		auto index = SearchIndex{};
+		for(const auto& fields : searchDocuments) {
+			index.add(fields);
+		}
+		blackHole += index.size();
+		return std::pair{searchDocuments.size(), std::size_t{0}};
+	});
+	auto searchIndex = SearchIndex{};
+	for(const auto& fields : searchDocuments) {
+		searchIndex.add(fields);
+	}
+	auto typedPlayerName = searchDocuments[searchDocuments.size() / 2].back();
+	runBenchmark("SearchIndex::search keystrokes 20000 replays", minimumTime, [&searchIndex, &typedPlayerName] {
+		for(auto length = std::size_t{1}; length <= typedPlayerName.size(); ++length) {
+			blackHole += searchIndex.search(std::wstring_view{typedPlayerName}.substr(0, length)).size();
+		}
+		searchIndex.search({}); //start typing again
+		return std::pair{typedPlayerName.size(), std::size_t{0}};
+	});
+
+	runBenchmark("BuiltinStrings::find", minimumTime, [] {
+		auto found = std::size_t{0};
+		for(const auto& string : BuiltinStrings::english) {
+			auto label = std::wstring{string.label.begin(), string.label.end()};
+			found += (BuiltinStrings::find(BuiltinStrings::english, label) != nullptr);
+		}
+		blackHole += found;
+		return std::pair{found, std::size_t{0}};
+	});
+
+	for(const auto& csf : csfs) {
+		auto readStrings = [&csf](auto makeReader) {
+			return [&csf, makeReader] {
+				using ValueType = std::pair<std::string, std::wstring>;
+				auto emplacer = [](std::vector<ValueType>& strings, ValueType&& string) { strings.emplace_back(std::move(string)); };
+				auto reader = makeReader(csf.content);
+				auto strings = MyCSF::readCSF<std::vector<ValueType>>(reader, emplacer);
+				blackHole += strings.size();
+				return std::pair{strings.size(), csf.content.size()};
+			};
+		};
+		runBenchmark("readCSF Range " + csf.name, minimumTime, readStrings(asRange));
+		runBenchmark("readCSF ContiguousReader " + csf.name, minimumTime, readStrings(asContiguousReader));
+		runBenchmark("readCSFParallel " + csf.name, minimumTime, [&csf] {
+			auto reader = asContiguousReader(csf.content);
+			auto strings = MyCSF::readCSFParallel(reader, Parallel::defaultThreadCount());
+			blackHole += strings.size();
+			return std::pair{strings.size(), csf.content.size()};
+		});
+		runBenchmark("LazyTable " + csf.name, minimumTime, [&csf] {
+			auto reader = asContiguousReader(csf.content);
+			auto table = MyCSF::LazyTable{reader};
+			blackHole += table.size();
+			return std::pair{table.size(), csf.content.size()};
+		});
+		runBenchmark("InternedCSF " + csf.name, minimumTime, [&csf] {
+			auto reader = asContiguousReader(csf.content);
+			auto table = MyCSF::InternedCSF{reader};
+			blackHole += table.size();
+			return std::pair{table.size(), csf.content.size()};
+		});
+
+		//the map of lower case wide labels is how the Control Center used to load a language
+		measureMemory("memory readCSF into std::map " + csf.name, [&csf] {
+			using Map = std::map<std::wstring, std::wstring>;
+			auto emplacer = [](Map& map, std::pair<std::string, std::wstring>&& string) {
+				auto& [label, text] = string;
+				std::transform(label.begin(), label.end(), label.begin(), [](char character) {
+					return static_cast<char>(MyCSF::Details::foldAscii(character));
+				});
+				map.emplace_hint(map.end(), std::wstring{label.begin(), label.end()}, std::move(text));
+			};
+			auto map = MyCSF::readCSF<Map>(asContiguousReader(csf.content), emplacer);
+			blackHole += map.size();
+		});
+		measureMemory("memory readCSF " + csf.name, [&csf] {
+			using ValueType = std::pair<std::string, std::wstring>;
+			auto emplacer = [](std::vector<ValueType>& strings, ValueType&& string) { strings.emplace_back(std::move(string)); };
+			auto strings = MyCSF::readCSF<std::vector<ValueType>>(asContiguousReader(csf.content), emplacer);
+			blackHole += strings.size();
+		});
+		measureMemory("memory LazyTable " + csf.name, [&csf] {
+			auto reader = asContiguousReader(csf.content);
+			auto table = MyCSF::LazyTable{reader};
+			blackHole += table.size();
+		});
+		measureMemory("memory InternedCSF " + csf.name, [&csf] {
+			auto reader = asContiguousReader(csf.content);
+			auto table = MyCSF::InternedCSF{reader};
+			blackHole += table.size() + table.textArenaSize();
+		});
+
+		auto lookupReader = asContiguousReader(csf.content);
+		auto lookupTable = MyCSF::LazyTable{lookupReader};
+		auto labels = std::vector<std::wstring>{};
+		MyCSF::readCSF<std::vector<std::pair<std::string, std::wstring>>>(asContiguousReader(csf.content), [&labels](auto&, auto&& string) {
+			labels.emplace_back(string.first.begin(), string.first.end());
+		});
+		runBenchmark("LazyTable::find " + csf.name, minimumTime, [&lookupTable, &labels] {
+			for(const auto& label : labels) {
+				blackHole += (lookupTable.find(label) != nullptr);
+			}
+			return std::pair{labels.size(), std::size_t{0}};
+		});
+
+		runBenchmark("LazyTable::compile " + csf.name, minimumTime, [&lookupTable, &csf] {
+			auto image = lookupTable.compile();
+			blackHole += image.size();
+			return std::pair{lookupTable.size(), csf.content.size()};
+		});
+		//a std::vector<char> is not guaranteed to be aligned to 4 bytes
+		auto compiled = lookupTable.compile();
+		auto alignedImage = std::vector<std::uint32_t>((compiled.size() + 3) / 4);
+		std::memcpy(alignedImage.data(), compiled.data(), compiled.size());
+		auto imageBegin = reinterpret_cast<const char*>(alignedImage.data());
+		runBenchmark("CompiledTable " + csf.name, minimumTime, [imageBegin, &compiled] {
+			auto image = Input::ContiguousReader{imageBegin, imageBegin + compiled.size()};
+			auto table = MyCSF::CompiledTable{image};
+			blackHole += table.size();
+			return std::pair{table.size(), compiled.size()};
+		});
+		auto imageReader = Input::ContiguousReader{imageBegin, imageBegin + compiled.size()};
+		auto compiledTable = MyCSF::CompiledTable{imageReader};
+		runBenchmark("CompiledTable::find " + csf.name, minimumTime, [&compiledTable, &labels] {
+			for(const auto& label : labels) {
+				blackHole += (compiledTable.find(label) != nullptr);
+			}
+			return std::pair{labels.size(), std::size_t{0}};
+		});
+
+		auto reader = asContiguousReader(csf.content);
+		auto strings = MyCSF::readCSF<std::vector<std::pair<std::string, std::wstring>>>(reader, [](auto& strings, auto&& string) {
+			strings.emplace_back(std::move(string));
+		});
+		runBenchmark("writeCSF " + csf.name, minimumTime, [&strings, output = std::vector<char>{}]() mutable {
+			output.clear();
+			MyCSF::writeCSF(Input::Range{strings.cbegin(), strings.cend()}, std::back_inserter(output));
+			blackHole += output.size();
+			return std::pair{strings.size(), output.size()};
+		});
+		runBenchmark("writeCSFToBuffer " + csf.name, minimumTime, [&strings] {
+			auto output = MyCSF::writeCSFToBuffer(Input::Range{strings.cbegin(), strings.cend()});
+			blackHole += output.size();
+			return std::pair{strings.size(), output.size()};
+		});
+
+		//a patch which replaces every tenth string and adds as many new strings
+		auto patchStrings = std::vector<std::pair<std::string, std::wstring>>{};
+		for(auto i = std::size_t{0}; i < strings.size(); i += 10) {
+			patchStrings.emplace_back(strings[i].first, strings[i].second + L" (patched)");
+			patchStrings.emplace_back(strings[i].first + ":Patch", strings[i].second);
+		}
+		auto patch = MyCSF::writeCSFToBuffer(Input::Range{patchStrings.cbegin(), patchStrings.cend()});
+		runBenchmark("overlayCSF " + csf.name, minimumTime, [&csf, &patch] {
+			auto base = asContiguousReader(csf.content);
+			auto patches = std::vector{asContiguousReader(patch)};
+			auto output = MyCSF::overlayCSF(base, patches);
+			blackHole += output.size();
+			return std::pair{std::size_t{1}, csf.content.size() + patch.size()};
+		});
+
+		//treat the whole file as a single masked payload to measure the kernels alone
+		auto unitCount = csf.content.size() / sizeof(std::uint16_t);
+		auto unmasked = std::wstring(unitCount, L'\0');
+		auto masked = std::vector<char>(unitCount * sizeof(std::uint16_t));
+		auto unmaskWith = [&](auto kernel) {
+			return [&, kernel] {
+				kernel(csf.content.data(), unitCount, unmasked.data());
+				blackHole += unmasked.back();
+				return std::pair{std::size_t{1}, masked.size()};
+			};
+		};
+		auto maskWith = [&](auto kernel) {
+			return [&, kernel] {
+				kernel(unmasked.data(), unitCount, masked.data());
+				blackHole += masked.back();
+				return std::pair{std::size_t{1}, masked.size()};
+			};
+		};
+		runBenchmark("unmaskScalar " + csf.name, minimumTime, unmaskWith(MyCSF::Details::unmaskScalar));
+		runBenchmark("unmask " + csf.name, minimumTime, unmaskWith(MyCSF::Details::unmask));
+		runBenchmark("maskScalar " + csf.name, minimumTime, maskWith(MyCSF::Details::maskScalar));
+		runBenchmark("mask " + csf.name, minimumTime, maskWith(MyCSF::Details::mask));
+	}
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+//Generated by BuiltinStringsGenerator.cpp, do not edit.
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+namespace BuiltinStrings {
+	using namespace std::string_view_literals;
+
+	struct BuiltinString {
+		std::string_view label; //case-folded for ASCII characters
+		std::wstring_view text;
+	};
+
+	constexpr unsigned foldAscii(unsigned character) noexcept {
+		return (character >= 'A' and character <= 'Z') ? character - 'A' + 'a' : character;
+	}
+
+	//Labels are compared case-insensitively for ASCII characters, like StringLess
+	constexpr int compareLabel(std::string_view folded, std::wstring_view label) noexcept {
+		for(auto i = std::size_t{0}; i < folded.size() and i < label.size(); ++i) {
+			auto x = static_cast<unsigned char>(folded[i]);
+			auto y = foldAscii(static_cast<unsigned>(label[i]));
+			if(x != y) {
+				return x < y ? -1 : 1;
+			}
+		}
+		return folded.size() == label.size() ? 0 : (folded.size() < label.size() ? -1 : 1);
+	}
+
+	//Binary search in a table sorted by label, returns nullptr if label is not found
+	template<std::size_t size>
+	constexpr const BuiltinString* find(const BuiltinString (&table)[size], std::wstring_view label) noexcept {
+		auto begin = std::size_t{0};
+		auto end = size;
+		while(begin < end) {
+			auto middle = begin + (end - begin) / 2;
+			auto comparison = compareLabel(table[middle].label, label);
+			if(comparison == 0) {
+				return &table[middle];
+			}
+			if(comparison < 0) {
+				begin = middle + 1;
+			}
+			else {
+				end = middle;
+			}
+		}
+		return nullptr;
+	}
+
+	//ra3barlauncher_english.csf
+	inline constexpr BuiltinString english[] = {
+		{"ra3barlauncher:about"sv, L"About this program"sv},
+		{"ra3barlauncher:abouttext"sv, L"[RA3Bar] RA3 QuickLoader v0.92\n\nThis is a unofficial player-made program which aims to improve some aspects of the original RA3.exe.\nFor more information, you can read <a href=\"http://www.gamereplays.org/community/index.php?showtopic=1013524\">this thread</a> on Red3.org, or <a href=\"http://tieba.baidu.com/p/5735228567\">this thread</a> as well if you can speak Chinese.\n\nYou can find the source code on <a href=\"http://github.com/lanyizi/RA3Bar-RA3Launcher\">GitHub</a>.\n\n        - Lanyi <<a href=\"mailto:lanyi@ra3.moe\">lanyi@ra3.moe</a>>"sv},
+		{"ra3barlauncher:clicksplashscreen"sv, L"Click to open Red Alert 3 Control Center"sv},
+		{"ra3barlauncher:commandline"sv, L"Command line arguments (optional):"sv},
+		{"ra3barlauncher:deauthorizenotsupported"sv, L"This program isn't capable of deauthorizing your game. Please use original RA3.exe for this kind of task."sv},
+		{"ra3barlauncher:easupportwebsite"sv, L"http://support.ea.com"sv},
+		{"ra3barlauncher:errormessage"sv, L"An error has occured. You can report error to these locations:\nGithub: https://github.com/lanyizi/RA3Bar-RA3Launcher/\nPosting on Red3.org: https://www.gamereplays.org/community/?showtopic=1013524\nE-mail: lanyi@ra3.moe\n\nBelow is error message:"sv},
+		{"ra3barlauncher:filterreplays"sv, L"Filter replays by name, map, player or mod"sv},
+		{"ra3barlauncher:fixreplay"sv, L"Fix Replay"sv},
+		{"ra3barlauncher:fixreplayfailure"sv, L"An error occured when trying to fix the replay."sv},
+		{"ra3barlauncher:fixreplaynothingchanged"sv, L"Haven't found any corrupted data when trying to fix the replay. No changes were made to the replay file."sv},
+		{"ra3barlauncher:fixreplaysuccess"sv, L"The replay has been fixed.\r\nNow you should be able to watch it."sv},
+		{"ra3barlauncher:fixreplaywillreplaceoriginal"sv, L"Please note that by fixing the replay, all contents from the first corrupted data onwards will be lost.\r\nDo you still want to fix the replay?"sv},
+		{"ra3barlauncher:needoriginallauncher"sv, L"Need to use original RA3.exe"sv},
+		{"ra3barlauncher:openmodfolder"sv, L"Mod Folder"sv},
+		{"ra3barlauncher:openreplayfolder"sv, L"Replay folder"sv},
+		{"ra3barlauncher:replaycannotbeparsed"sv, L"Error when trying to parse replay file."sv},
+		{"ra3barlauncher:replaycannotbeplayed"sv, L"Replay cannot be played"sv},
+		{"ra3barlauncher:replaydoesnothavecommentator"sv, L"Can't play this replay directly. Please load this replay manually in game's Replay Theatre after having launched Red Alert 3."sv},
+		{"ra3barlauncher:replaymodambiguity"sv, L"Multiple mods with same name found.\r\nPlease load this replay manually in game's Replay Theatre after having loaded your mod."sv},
+		{"ra3barlauncher:replayneedstobefixed"sv, L"Corrupted replay needs to be fixed."sv},
+		{"ra3barlauncher:replayneedstobefixedtext"sv, L"This replay file looks like damaged. You need to fix it in order to watch it."sv},
+		{"ra3barlauncher:resourceauthors"sv, L"RA3 Bar logo designed by \x6DE1\x5B9A\x5723.\r\nArmor Rush background drawn by Link Nov."sv},
+		{"ra3barlauncher:updatenotsupported"sv, L"This program isn't capable of updating your game. Please use original RA3.exe for this kind of task."sv},
+	};
+
+	//ra3barlauncher_chinese.csf
+	inline constexpr BuiltinString chinese[] = {
+		{"ra3barlauncher:about"sv, L"\x5173\x4E8E\x672C\x7A0B\x5E8F"sv},
+		{"ra3barlauncher:abouttext"sv, L"\x3010\x7EA2\x8B66" L"3\x5427\x3011\x7EA2\x8272\x8B66\x6212" L"3\x5FEB\x6377\x542F\x52A8\x5668 v0.92\n\n\x8FD9\x662F\x4E00\x4E2A\x7531\x73A9\x5BB6\x5236\x4F5C\x7684\x975E\x5B98\x65B9\x7A0B\x5E8F\xFF0C\x65E8\x5728\x89E3\x51B3\x6E38\x620F\x539F\x672C\x7684RA3.exe\x5B58\x5728\x7684\x4E00\x4E9B\x95EE\x9898\xFF08\x4E3B\x8981\x662F\x539F\x672C\x7684RA3.exe\x542F\x52A8\x6E38\x620F\x901F\x5EA6\x592A\x6162\x4E86...\xFF09\x3002\x672C\x7A0B\x5E8F\x8FD8\x63D0\x4F9B\x4E86\x4E00\x4E9B\x989D\x5916\x7684\x529F\x80FD\xFF0C\x5E0C\x671B\x5B83\x4EEC\x80FD\x6539\x5584\x5927\x5BB6\x7684\x6E38\x620F\x4F53\x9A8C~\n\x66F4\x591A\x5173\x4E8E\x672C\x7A0B\x5E8F\x7684\x4FE1\x606F\x53EF\x4EE5\x5728\x7EA2\x8B66" L"3\x5427\x7684<a href=\"http://tieba.baidu.com/p/5735228567\">\x8FD9\x4E2A\x5E16\x5B50</a>\x91CC\x627E\x5230\x3002\x6B22\x8FCE\x5728\x5E16\x5B50\x91CC\x56DE\x5E16~\n\x6709\x9700\x8981\x7684\x8BDD\x4E5F\x53EF\x4EE5\x7528\x90AE\x4EF6\x8054\x7CFB\xFF0C\x5730\x5740<a href=\"mailto:lanyi@ra3.moe\">lanyi@ra3.moe</a>\n\x672C\x7A0B\x5E8F\x7684\x6E90\x4EE3\x7801\x53EF\x4EE5\x5728<a href=\"http://github.com/lanyizi/RA3Bar-RA3Launcher\">GitHub</a>\x4E0A\x627E\x5230~\n\n            - \x5C9A\x4F9D"sv},
+		{"ra3barlauncher:clicksplashscreen"sv, L"\x70B9\x51FB\x6253\x5F00\x7EA2\x8272\x8B66\x6212" L"3\x63A7\x5236\x4E2D\x5FC3"sv},
+		{"ra3barlauncher:commandline"sv, L"\x6E38\x620F\x547D\x4EE4\x884C\x53C2\x6570\xFF08\x53EF\x9009\xFF09\xFF1A"sv},
+		{"ra3barlauncher:deauthorizenotsupported"sv, L"\x672C\x7A0B\x5E8F\x65E0\x6CD5\x5E2E\x4F60\x89E3\x9664\x6E38\x620F\x6388\x6743\x3002\x8BF7\x4F7F\x7528\x539F\x672C\x7684RA3.exe\x6267\x884C\x548C\x6E38\x620F\x6388\x6743\x3001\x6FC0\x6D3B\x6709\x5173\x7684\x64CD\x4F5C\x3002"sv},
+		{"ra3barlauncher:easupportwebsite"sv, L"http://support.ea.com"sv},
+		{"ra3barlauncher:errormessage"sv, L"\x672C\x7A0B\x5E8F\x51FA\x73B0\x4E86\x4E00\x4E2A\x95EE\x9898\x3002\x4F60\x53EF\x4EE5\x628A\x9519\x8BEF\x4FE1\x606F\x53D1\x5230\x4E0B\x9762\x8FD9\x4E9B\x5730\x65B9\xFF1A\nGithub: https://github.com/lanyizi/RA3Bar-RA3Launcher/\n\x5728\x7EA2\x8B66" L"3\x5427\x53D1\x5E16: https://tieba.baidu.com/p/5735228567\n\x90AE\x7BB1\xFF1Alanyi@ra3.moe\n\n\x5047\x5982\x60A8\x662F\x5728\x542F\x52A8\x65E5\x5195Mod\x65F6\x51FA\x73B0\x7684\x95EE\x9898\xFF0C\x4E5F\x53EF\x4EE5\x76F4\x63A5\x8054\x7CFB\x65E5\x5195Mod\x5236\x4F5C\x7EC4\x3002\n\n\x4EE5\x4E0B\x662F\x9519\x8BEF\x4FE1\x606F\xFF1A"sv},
+		{"ra3barlauncher:filterreplays"sv, L"\x6309\x540D\x79F0\x3001\x5730\x56FE\x3001\x73A9\x5BB6\x6216Mod\x7B5B\x9009\x5F55\x50CF"sv},
+		{"ra3barlauncher:fixreplay"sv, L"\x4FEE\x590D\x5F55\x50CF"sv},
+		{"ra3barlauncher:fixreplayfailure"sv, L"\x5C1D\x8BD5\x4FEE\x590D\x5F55\x50CF\x65F6\x53D1\x751F\x4E86\x4E00\x4E2A\x9519\x8BEF\x3002"sv},
+		{"ra3barlauncher:fixreplaynothingchanged"sv, L"\x6CA1\x6709\x5728\x5F55\x50CF\x91CC\x53D1\x73B0\x4EFB\x4F55\x635F\x574F\x7684\x3001\x9700\x8981\x4FEE\x590D\x7684\x5185\x5BB9\x3002\x6CA1\x6709\x5BF9\x5F55\x50CF\x6587\x4EF6\x8FDB\x884C\x4EFB\x4F55\x66F4\x6539\x3002"sv},
+		{"ra3barlauncher:fixreplaysuccess"sv, L"\x5F55\x50CF\x5DF2\x88AB\x4FEE\x590D\x3002\r\n\x4F60\x73B0\x5728\x53EF\x4EE5\x64AD\x653E\x8FD9\x4E2A\x5F55\x50CF\x4E86\x3002"sv},
+		{"ra3barlauncher:fixreplaywillreplaceoriginal"sv, L"\x8BF7\x6CE8\x610F\x4E00\x65E6\x4FEE\x590D\x5F55\x50CF, \x9664\x4E86\x635F\x574F\x7684\x5F55\x50CF\x6570\x636E\x4EE5\x5916\xFF0C\x5DF2\x635F\x574F\x6570\x636E\x4E4B\x540E\x7684\x6240\x6709\x5176\x4ED6\x5F55\x50CF\x5185\x5BB9\x4E5F\x90FD\x5C06\x88AB\x5220\x9664\x3002\r\n\x4F60\x786E\x5B9A\x60F3\x8981\x4FEE\x590D\x8FD9\x4E2A\x5F55\x50CF\x5417\xFF1F"sv},
+		{"ra3barlauncher:needoriginallauncher"sv, L"\x9700\x8981\x4F7F\x7528\x539F\x6765\x7684RA3.exe"sv},
+		{"ra3barlauncher:openmodfolder"sv, L"Mod\x6587\x4EF6\x5939"sv},
+		{"ra3barlauncher:openreplayfolder"sv, L"\x5F55\x50CF\x6587\x4EF6\x5939"sv},
+		{"ra3barlauncher:replaycannotbeparsed"sv, L"\x5C1D\x8BD5\x89E3\x6790\x5F55\x50CF\x6587\x4EF6\x65F6\x53D1\x751F\x9519\x8BEF"sv},
+		{"ra3barlauncher:replaycannotbeplayed"sv, L"\x65E0\x6CD5\x64AD\x653E\x5F55\x50CF"sv},
+		{"ra3barlauncher:replaydoesnothavecommentator"sv, L"\x65E0\x6CD5\x76F4\x63A5\x52A0\x8F7D\x8FD9\x4E2A\x5F55\x50CF\x3002\x8BF7\x5148\x542F\x52A8\x7EA2\x8272\x8B66\x6212" L"3\xFF0C\x7136\x540E\x5728\x6E38\x620F\x7684\x91CD\x64AD\x5267\x573A\x91CC\x64AD\x653E\x8BE5\x5F55\x50CF\x3002"sv},
+		{"ra3barlauncher:replaymodambiguity"sv, L"\x4F60\x7684\x7535\x8111\x91CC\x6709\x597D\x51E0\x4E2A\x540C\x540D\x7684Mod\xFF0C\x672C\x7A0B\x5E8F\x5E76\x4E0D\x80FD\x786E\x5B9A\x5F55\x50CF\x91CC\x4F7F\x7528\x4E86\x54EA\x4E00\x4E2AMod\x3002\r\n\x8BF7\x5148\x542F\x52A8\x52A0\x8F7D\x4E86\x6B63\x786EMod\x7684\x7EA2\x8272\x8B66\x6212" L"3\xFF0C\x7136\x540E\x5728\x6E38\x620F\x7684\x91CD\x64AD\x5267\x573A\x91CC\x64AD\x653E\x8BE5\x5F55\x50CF\x3002"sv},
+		{"ra3barlauncher:replayneedstobefixed"sv, L"\x5F55\x50CF\x5DF2\x635F\x574F\xFF0C\x9700\x8981\x4FEE\x590D"sv},
+		{"ra3barlauncher:replayneedstobefixedtext"sv, L"\x8BE5\x5F55\x50CF\x6587\x4EF6\x5DF2\x7ECF\x635F\x574F\xFF0C\x4F60\x5FC5\x987B\x5148\x4FEE\x590D\x5F55\x50CF\x7136\x540E\x624D\x80FD\x64AD\x653E\x5B83\x3002"sv},
+		{"ra3barlauncher:resourceauthors"sv, L"\x7EA2\x8B66" L"3\x5427\x5427\x5FBD\x7531" L"BLack\x5723\xFF08\x6DE1\x5B9A\x5723\xFF09\x8BBE\x8BA1\x3002\r\nArmor Rush\x80CC\x666F\x56FE\x7531\x6797\x51EF\x8BFA\x592B\xFF08\x8BFA\x592B\x8FD8\x662F\x8BFA\x5495\xFF1F\xFF09\x7ED8\x5236\x3002"sv},
+		{"ra3barlauncher:updatenotsupported"sv, L"\x672C\x7A0B\x5E8F\x65E0\x6CD5\x5E2E\x4F60\x66F4\x65B0\x6E38\x620F\xFF0C\x8BF7\x4F7F\x7528\x539F\x672C\x7684RA3.exe\x6765\x66F4\x65B0\x4F60\x7684\x6E38\x620F\x3002"sv},
+	};
+}
@@ -0,0 +1,190 @@
+//Build step which turns the built-in CSF files into BuiltinStrings.hpp, so they don't need to be parsed at run time.
+//It only uses the portable parsers, so it can be built and run on both Windows and Linux:
+//    g++ BuiltinStringsGenerator.cpp -o builtinstringsgenerator -O2 -Wall -std=c++17
+//    ./builtinstringsgenerator ra3barlauncher_english.csf ra3barlauncher_chinese.csf BuiltinStrings.hpp
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Input.hpp"
+#include "CSFParser.hpp"
+
+namespace {
+	using namespace std::string_view_literals;
+
+	using CSFString = std::pair<std::string, std::wstring>;
+
+	constexpr auto usage = "Usage: builtinstringsgenerator <english.csf> <chinese.csf> <output.hpp>\n"sv;
+
+	//Lines of the generated header end with CRLF, like every other source file
+	constexpr auto endLine = "\r\n"sv;
+
+	constexpr auto preamble =
+	    "#pragma once\r\n"
+	    "#include <cstddef>\r\n"
+	    "#include <string_view>\r\n"
+	    "\r\n"
+	    "namespace BuiltinStrings {\r\n"
+	    "\tusing namespace std::string_view_literals;\r\n"
+	    "\r\n"
+	    "\tstruct BuiltinString {\r\n"
+	    "\t\tstd::string_view label; //case-folded for ASCII characters\r\n"
+	    "\t\tstd::wstring_view text;\r\n"
+	    "\t};\r\n"
+	    "\r\n"
+	    "\tconstexpr unsigned foldAscii(unsigned character) noexcept {\r\n"
+	    "\t\treturn (character >= 'A' and character <= 'Z') ? character - 'A' + 'a' : character;\r\n"
+	    "\t}\r\n"
+	    "\r\n"
+	    "\t//Labels are compared case-insensitively for ASCII characters, like StringLess\r\n"
+	    "\tconstexpr int compareLabel(std::string_view folded, std::wstring_view label) noexcept {\r\n"
+	    "\t\tfor(auto i = std::size_t{0}; i < folded.size() and i < label.size(); ++i) {\r\n"
+	    "\t\t\tauto x = static_cast<unsigned char>(folded[i]);\r\n"
+	    "\t\t\tauto y = foldAscii(static_cast<unsigned>(label[i]));\r\n"
+	    "\t\t\tif(x != y) {\r\n"
+	    "\t\t\t\treturn x < y ? -1 : 1;\r\n"
+	    "\t\t\t}\r\n"
+	    "\t\t}\r\n"
+	    "\t\treturn folded.size() == label.size() ? 0 : (folded.size() < label.size() ? -1 : 1);\r\n"
+	    "\t}\r\n"
+	    "\r\n"
+	    "\t//Binary search in a table sorted by label, returns nullptr if label is not found\r\n"
+	    "\ttemplate<std::size_t size>\r\n"
+	    "\tconstexpr const BuiltinString* find(const BuiltinString (&table)[size], std::wstring_view label) noexcept {\r\n"
+	    "\t\tauto begin = std::size_t{0};\r\n"
+	    "\t\tauto end = size;\r\n"
+	    "\t\twhile(begin < end) {\r\n"
+	    "\t\t\tauto middle = begin + (end - begin) / 2;\r\n"
+	    "\t\t\tauto comparison = compareLabel(table[middle].label, label);\r\n"
+	    "\t\t\tif(comparison == 0) {\r\n"
+	    "\t\t\t\treturn &table[middle];\r\n"
+	    "\t\t\t}\r\n"
+	    "\t\t\tif(comparison < 0) {\r\n"
+	    "\t\t\t\tbegin = middle + 1;\r\n"
+	    "\t\t\t}\r\n"
+	    "\t\t\telse {\r\n"
+	    "\t\t\t\tend = middle;\r\n"
+	    "\t\t\t}\r\n"
+	    "\t\t}\r\n"
+	    "\t\treturn nullptr;\r\n"
+	    "\t}\r\n"sv;
+
+	std::vector<char> readBinaryFile(const std::string& fileName) {
+		auto file = std::ifstream{fileName, std::ios::binary};
+		if(not file) {
+			throw std::runtime_error("Cannot open " + fileName);
+		}
+		return std::vector<char>{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	}
+
+	//Strings sorted by case-folded label, only the first one of strings with the same label is kept, like LazyTable
+	std::vector<CSFString> loadSortedStrings(const std::string& fileName) {
+		auto content = readBinaryFile(fileName);
+		auto csf = Input::ContiguousReader{content.data(), content.data() + content.size()};
+		auto strings = MyCSF::readCSF<std::vector<CSFString>>(csf, [](std::vector<CSFString>& strings, CSFString&& string) {
+			strings.emplace_back(std::move(string));
+		});
+		if(Input::hasFailed(csf)) {
+			throw std::invalid_argument("Failed to parse " + fileName);
+		}
+		for(auto& [label, string] : strings) {
+			std::transform(label.begin(), label.end(), label.begin(), [](char character) {
+				return static_cast<char>(MyCSF::Details::foldAscii(character));
+			});
+		}
+		std::stable_sort(strings.begin(), strings.end(), [](const CSFString& a, const CSFString& b) {
+			return a.first < b.first;
+		});
+		strings.erase(std::unique(strings.begin(), strings.end(), [](const CSFString& a, const CSFString& b) {
+			return a.first == b.first;
+		}), strings.end());
+		return strings;
+	}
+
+	bool isHexDigit(unsigned character) {
+		return (character >= '0' and character <= '9') or (character >= 'a' and character <= 'f') or (character >= 'A' and character <= 'F');
+	}
+
+	//Characters which are not printable ASCII are written as escape sequences.
+	//A hexadecimal escape sequence doesn't stop before a hexadecimal digit, so the literal is split there.
+	template<typename Character>
+	void writeLiteral(std::ostream& output, std::basic_string_view<Character> string) {
+		constexpr auto isWide = sizeof(Character) > 1;
+		output << (isWide ? "L\"" : "\"");
+		auto lastWasHexEscape = false;
+		for(auto character : string) {
+			auto value = static_cast<unsigned>(static_cast<std::make_unsigned_t<Character>>(character)) bitand 0xFFFFu;
+			if(lastWasHexEscape and isHexDigit(value)) {
+				output << (isWide ? "\" L\"" : "\" \"");
+			}
+			lastWasHexEscape = false;
+			switch(value) {
+				case '\r': output << "\\r"; continue;
+				case '\n': output << "\\n"; continue;
+				case '\t': output << "\\t"; continue;
+				case '"': output << "\\\""; continue;
+				case '\\': output << "\\\\"; continue;
+			}
+			if(value >= 0x20 and value < 0x7F) {
+				output << static_cast<char>(value);
+				continue;
+			}
+			output << "\\x" << std::hex << std::uppercase << std::setw(isWide ? 4 : 2) << std::setfill('0') << value << std::dec;
+			lastWasHexEscape = true;
+		}
+		output << "\"sv";
+	}
+
+	void writeTable(std::ostream& output, std::string_view name, const std::string& sourceFileName, const std::vector<CSFString>& strings) {
+		output << endLine << "\t//" << sourceFileName << endLine;
+		output << "\tinline constexpr BuiltinString " << name << "[] = {" << endLine;
+		for(const auto& [label, string] : strings) {
+			output << "\t\t{";
+			writeLiteral(output, std::string_view{label});
+			output << ", ";
+			writeLiteral(output, std::wstring_view{string});
+			output << "}," << endLine;
+		}
+		output << "\t};" << endLine;
+	}
+}
+
+int main(int argc, char** argv) {
+	if(argc != 4) {
+		std::cerr << usage;
+		return 2;
+	}
+	try {
+		auto englishFileName = std::string{argv[1]};
+		auto chineseFileName = std::string{argv[2]};
+		auto english = loadSortedStrings(englishFileName);
+		auto chinese = loadSortedStrings(chineseFileName);
+
+		auto header = std::ostringstream{};
+		header << "//Generated by BuiltinStringsGenerator.cpp, do not edit." << endLine;
+		header << preamble;
+		writeTable(header, "english"sv, englishFileName, english);
+		writeTable(header, "chinese"sv, chineseFileName, chinese);
+		header << "}" << endLine;
+
+		auto output = std::ofstream{argv[3], std::ios::binary};
+		output << header.str();
+		if(not output) {
+			throw std::runtime_error(std::string{"Failed to write "} + argv[3]);
+		}
+	}
+	catch(const std::exception& error) {
+		std::cerr << error.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -15,7 +15,12 @@
 #include <string>
 #include <string_view>
 #include <stdexcept>
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
 #include "Input.hpp"
+#include "Parallel.hpp"
 
 namespace MyCSF {
 
@@ -32,19 +37,142 @@ namespace MyCSF {
 	//    for(const auto& [label, string] : strings) {
 	//        ...
 	//    }
-	//This function asssumes that machine's endianness is little-endian, and sizeof(wchar_t) == 2.
+	//csf can also be an lvalue Input::ContiguousReader, then errors are reported by
+	//Input::hasFailed(csf) instead of exceptions, and the returned container should be discarded on failure.
+	//This function asssumes that machine's endianness is little-endian.
 	template<typename Container, typename CSFStringEmplacer, typename Range>
 	Container readCSF(Range&& csf, CSFStringEmplacer csfStringEmplacer = CSFStringEmplacer{});
 
+	//Same as readCSF with an Input::ContiguousReader into a std::vector<std::pair<std::string, std::wstring>>,
+	//but labels and strings are decoded by threadCount threads, after the offset of every string has been found in a first pass.
+	//Returned strings and errors reported by Input::hasFailed(csf) are the same as readCSF.
+	inline std::vector<std::pair<std::string, std::wstring>> readCSFParallel(Input::ContiguousReader& csf, std::size_t threadCount);
+
 	//Write CSF from a ForwardIterator Range with an OutputIterator.
 	//ForwardIterator should be dereferencable into something that after structured binding,
 	//could be converted to std::string (label) and std::wstring (text)
 	//Example:
 	//    writeCSF(Input::Range{vector.begin(), vector.end()}, std::ostreambuf_iterator{file});
-	//This function asssumes that machine's endianness is little-endian, and sizeof(wchar_t) == 2.
+	//This function asssumes that machine's endianness is little-endian.
 	template<typename ForwardIteratorRange, typename OutputIterator>
 	OutputIterator writeCSF(ForwardIteratorRange stringsToBeWritten, OutputIterator output);
 
+	//Exact number of bytes written by writeCSF
+	template<typename ForwardIteratorRange>
+	std::size_t getCSFSize(ForwardIteratorRange stringsToBeWritten);
+
+	//Same as writeCSF, but the output buffer is allocated once with the exact size, and strings are copied into it in bulk
+	template<typename ForwardIteratorRange>
+	std::vector<char> writeCSFToBuffer(ForwardIteratorRange stringsToBeWritten);
+
+	//A string of a CSF file, which still points into the CSF data
+	struct LazyEntry {
+		std::string_view label;
+		const char* maskedText;   //masked UTF-16 LE
+		std::uint32_t length;     //number of UTF-16 units
+	};
+
+	//Index of CSF strings without copying or decoding them, strings are decoded only by LazyTable::decode.
+	//The CSF data must outlive the table.
+	//Labels are compared case-insensitively for ASCII characters, like StringLess.
+	//Labels are case-folded once into a contiguous arena and looked up by an open-addressing hash table.
+	class LazyTable {
+		public:
+			LazyTable() = default;
+			//Errors are reported by Input::hasFailed(csf), the table is empty in that case
+			explicit LazyTable(Input::ContiguousReader& csf);
+
+			std::size_t size() const noexcept { return this->entries.size(); }
+			//Entries in the same order as in the CSF file
+			auto begin() const noexcept { return this->entries.cbegin(); }
+			auto end() const noexcept { return this->entries.cend(); }
+			const LazyEntry* find(std::wstring_view label) const noexcept;
+			const LazyEntry* find(std::string_view label) const noexcept;
+			static std::wstring decode(const LazyEntry& entry);
+			//Image of the same hash table with decoded strings, which can be loaded by CompiledTable
+			std::vector<char> compile() const;
+
+		private:
+			template<typename Label>
+			const LazyEntry* findFolded(Label label) const noexcept;
+
+			std::vector<LazyEntry> entries;          //in the same order as in the CSF file
+			std::string foldedLabels;                //arena of case-folded labels
+			std::vector<std::uint32_t> labelOffsets; //offset of entries[i]'s label in foldedLabels
+			std::vector<std::uint32_t> slots;        //index into entries, or Details::emptySlot; size is a power of two
+	};
+
+	//A string of a compiled table, offsets are relative to the arenas of the table
+	struct CompiledEntry {
+		std::uint32_t labelOffset;
+		std::uint32_t labelSize;
+		std::uint32_t textOffset; //in UTF-16 units
+		std::uint32_t textLength; //in UTF-16 units
+	};
+
+	//Hash table produced by LazyTable::compile, used directly over its image (for example a mapped file) without parsing.
+	//The image must outlive the table, and must be aligned to 4 bytes.
+	class CompiledTable {
+		public:
+			CompiledTable() = default;
+			//The whole image is validated, errors are reported by Input::hasFailed(image), the table is empty in that case
+			explicit CompiledTable(Input::ContiguousReader& image);
+
+			std::size_t size() const noexcept { return this->entryCount; }
+			const CompiledEntry* find(std::wstring_view label) const noexcept;
+			const CompiledEntry* find(std::string_view label) const noexcept;
+			std::wstring decode(const CompiledEntry& entry) const;
+
+		private:
+			template<typename Label>
+			const CompiledEntry* findFolded(Label label) const noexcept;
+
+			const std::uint32_t* slots = nullptr;
+			std::size_t slotCount = 0;
+			const CompiledEntry* entries = nullptr;
+			std::size_t entryCount = 0;
+			const char* foldedLabels = nullptr;
+			const char* text = nullptr; //UTF-16 LE, not masked
+	};
+
+	//A string of an InternedCSF, both views point into the arenas of the InternedCSF
+	struct InternedEntry {
+		std::string_view label;
+		std::wstring_view text;
+	};
+
+	//Labels and texts of a CSF decoded into two arenas, each one is allocated once with its exact size after every string has been found.
+	//Identical texts are stored only once. Entries are in the same order as in the CSF file.
+	class InternedCSF {
+		public:
+			InternedCSF() = default;
+			//Errors are reported by Input::hasFailed(csf), the table is empty in that case
+			explicit InternedCSF(Input::ContiguousReader& csf);
+			//entries are views into labels and texts: a copy would still point into the original
+			InternedCSF(const InternedCSF&) = delete;
+			InternedCSF& operator=(const InternedCSF&) = delete;
+			InternedCSF(InternedCSF&&) = default;
+			InternedCSF& operator=(InternedCSF&&) = default;
+
+			std::size_t size() const noexcept { return this->entries.size(); }
+			auto begin() const noexcept { return this->entries.cbegin(); }
+			auto end() const noexcept { return this->entries.cend(); }
+			//Number of characters in the text arena, smaller than the total length of texts when some of them are identical
+			std::size_t textArenaSize() const noexcept { return this->texts.size(); }
+
+		private:
+			std::vector<InternedEntry> entries; //in the same order as in the CSF file
+			std::vector<char> labels;           //arena of labels
+			std::vector<wchar_t> texts;         //arena of distinct texts
+	};
+
+	//Merge patch CSFs into a base CSF by label (case-insensitive for ASCII characters, like LazyTable):
+	//strings of base keep their order and take the text of the last patch which has the same label,
+	//strings which are only found in patches are appended in the order they first appear.
+	//Every file is only indexed, texts are copied into the output without being decoded.
+	//Errors are reported by Input::hasFailed of base or patches, the result is empty in that case.
+	inline std::vector<char> overlayCSF(Input::ContiguousReader& base, std::vector<Input::ContiguousReader>& patches);
+
 	/*
 		CSF file format
 
@@ -91,14 +219,89 @@ namespace MyCSF {
 	namespace Details {
 		using namespace std::string_view_literals;
 		static constexpr auto header = std::string_view {" FSC"sv};
-		static constexpr auto zero32Bit = std::string_view {"\x00\x00\x00\x00"sv};
 		static constexpr auto lbl = std::string_view {" LBL" "\x01\x00\x00\x00"sv};
 		static constexpr auto rts = std::string_view {" RTS"sv};
+		static constexpr auto version = std::uint32_t{3};
 
 		using namespace Input;
 
-		template<typename InputIterator>
-		std::pair<std::string, std::wstring> nextString(Range<InputIterator>& input) {
+		//Masking and unmasking are the same operation: every UTF-16 unit is XORed with 0xFFFF.
+		//The scalar versions are used for remaining units and where SSE2 is not available.
+		inline void unmaskScalar(const char* masked, std::size_t length, wchar_t* output) noexcept {
+			for(auto i = std::size_t{0}; i < length; ++i) {
+				auto unit = std::uint16_t{};
+				std::memcpy(&unit, masked + i * sizeof(unit), sizeof(unit));
+				output[i] = static_cast<wchar_t>(unit xor 0xFFFFu);
+			}
+		}
+
+		inline void maskScalar(const wchar_t* string, std::size_t length, char* output) noexcept {
+			for(auto i = std::size_t{0}; i < length; ++i) {
+				auto unit = static_cast<std::uint16_t>(string[i] xor 0xFFFFu);
+				std::memcpy(output + i * sizeof(unit), &unit, sizeof(unit));
+			}
+		}
+
+		//Unmask length UTF-16 units into output
+		inline void unmask(const char* masked, std::size_t length, wchar_t* output) noexcept {
+			auto i = std::size_t{0};
+			if constexpr(sizeof(wchar_t) == sizeof(std::uint16_t)) {
+				auto outputBytes = reinterpret_cast<char*>(output);
+#ifdef INPUT_HPP_USE_SSE2
+				const auto allOnes = _mm_set1_epi32(-1);
+				for(; length - i >= 8; i += 8) {
+					auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masked + i * 2));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(outputBytes + i * 2), _mm_xor_si128(units, allOnes));
+				}
+#endif
+			}
+			else {
+#ifdef INPUT_HPP_USE_SSE2
+				//widen every 16-bit unit into a 32-bit wchar_t
+				const auto allOnes = _mm_set1_epi32(-1);
+				const auto zero = _mm_setzero_si128();
+				for(; length - i >= 8; i += 8) {
+					auto units = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(masked + i * 2)), allOnes);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_unpacklo_epi16(units, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 4), _mm_unpackhi_epi16(units, zero));
+				}
+#endif
+			}
+			unmaskScalar(masked + i * 2, length - i, output + i);
+		}
+
+		//Mask length characters of string into output as UTF-16 LE units
+		inline void mask(const wchar_t* string, std::size_t length, char* output) noexcept {
+			auto i = std::size_t{0};
+			if constexpr(sizeof(wchar_t) == sizeof(std::uint16_t)) {
+				auto stringBytes = reinterpret_cast<const char*>(string);
+#ifdef INPUT_HPP_USE_SSE2
+				const auto allOnes = _mm_set1_epi32(-1);
+				for(; length - i >= 8; i += 8) {
+					auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stringBytes + i * 2));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 2), _mm_xor_si128(units, allOnes));
+				}
+#endif
+			}
+			else {
+#ifdef INPUT_HPP_USE_SSE2
+				//narrow 32-bit wchar_t into 16-bit units, sign extending the low 16 bits keeps _mm_packs_epi32 from saturating
+				const auto allOnes = _mm_set1_epi32(-1);
+				for(; length - i >= 8; i += 8) {
+					auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + i));
+					auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + i + 4));
+					low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+					high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+					auto units = _mm_xor_si128(_mm_packs_epi32(low, high), allOnes);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 2), units);
+				}
+#endif
+			}
+			maskScalar(string + i, length - i, output + i * 2);
+		}
+
+		template<typename Reader>
+		std::pair<std::string, std::wstring> nextString(Reader& input) {
 
 			readAndCheckMagic(input, lbl);
 
@@ -110,28 +313,93 @@ namespace MyCSF {
 
 			auto wideCharCount= copyBytes<std::uint32_t>(input);
 			auto string = std::wstring{wideCharCount, L'\xFFFF', std::wstring::allocator_type{}};
-			for(auto& wideChar : string) { wideChar = wideChar xor copyBytes<wchar_t>(input); }
+			for(auto& wideChar : string) { wideChar = wideChar xor static_cast<wchar_t>(copyBytes<std::uint16_t>(input)); }
+
+			return {std::move(label), std::move(string)};
+		}
+
+		inline std::pair<std::string, std::wstring> nextString(ContiguousReader& input) {
+			readAndCheckMagic(input, lbl);
+			auto labelSize = copyBytes<std::uint32_t>(input);
+			if(not input.take(labelSize)) {
+				return {};
+			}
+			auto label = std::string{input.current, labelSize};
+			input.current += labelSize;
+
+			readAndCheckMagic(input, rts);
+			auto wideCharCount = copyBytes<std::uint32_t>(input);
+			if(wideCharCount > input.remaining() / sizeof(std::uint16_t)) {
+				input.take(input.remaining() + 1); //reach end of data
+				return {};
+			}
+			auto string = std::wstring(wideCharCount, L'\0');
+			unmask(input.current, string.size(), string.data());
+			input.current += string.size() * sizeof(std::uint16_t);
 
 			return {std::move(label), std::move(string)};
 		}
 
+		//Validate a string in the same way as nextString, without decoding it
+		inline void skipString(ContiguousReader& input) {
+			readAndCheckMagic(input, lbl);
+			auto labelSize = copyBytes<std::uint32_t>(input);
+			if(not input.take(labelSize)) {
+				return;
+			}
+			input.current += labelSize;
+
+			readAndCheckMagic(input, rts);
+			auto wideCharCount = copyBytes<std::uint32_t>(input);
+			if(wideCharCount > input.remaining() / sizeof(std::uint16_t)) {
+				input.take(input.remaining() + 1); //reach end of data
+				return;
+			}
+			input.current += std::size_t{wideCharCount} * sizeof(std::uint16_t);
+		}
+
 		template<typename OutputIterator, typename T>
 		OutputIterator writeAsBytes(OutputIterator out, const T& data, std::size_t bytes = sizeof(T)) {
 			return std::copy_n(reinterpret_cast<const char*>(&data), bytes, out);
 		}
 
 		template<typename OutputIterator>
-		OutputIterator writeString(const std::string& label, std::wstring string, OutputIterator out) {
+		OutputIterator writeString(std::string_view label, std::wstring_view string, OutputIterator out) {
 
 			out = writeAsBytes(out, *(lbl.data()), lbl.size());
-			out = writeAsBytes(out, label.size());
+			out = writeAsBytes(out, static_cast<std::uint32_t>(label.size()));
 			out = writeAsBytes(out, *(label.data()), label.size());
 
 			out = writeAsBytes(out, *(rts.data()), rts.size());
-			out = writeAsBytes(out, string.size());
-			for(auto& character : string) character = character xor L'\xFFFF';
-			return writeAsBytes(out, *(string.data()), sizeof(*string.data()) * string.length());
+			out = writeAsBytes(out, static_cast<std::uint32_t>(string.size()));
+			//mask a block of characters at once, then copy them into the output
+			constexpr auto blockLength = std::size_t{256};
+			char block[blockLength * sizeof(std::uint16_t)];
+			for(auto i = std::size_t{0}; i < string.size(); i += blockLength) {
+				auto length = std::min(blockLength, string.size() - i);
+				mask(string.data() + i, length, block);
+				out = std::copy_n(block, length * sizeof(std::uint16_t), out);
+			}
+			return out;
 		}
+
+		//Strings can be masked directly into a buffer which is large enough
+		inline char* writeString(std::string_view label, std::wstring_view string, char* out) {
+			out = writeAsBytes(out, *(lbl.data()), lbl.size());
+			out = writeAsBytes(out, static_cast<std::uint32_t>(label.size()));
+			out = std::copy_n(label.data(), label.size(), out);
+
+			out = writeAsBytes(out, *(rts.data()), rts.size());
+			out = writeAsBytes(out, static_cast<std::uint32_t>(string.size()));
+			mask(string.data(), string.size(), out);
+			return out + string.size() * sizeof(std::uint16_t);
+		}
+
+		constexpr std::size_t getStringSize(std::size_t labelSize, std::size_t textLength) noexcept {
+			return lbl.size() + sizeof(std::uint32_t) + labelSize + rts.size() + sizeof(std::uint32_t) + textLength * sizeof(std::uint16_t);
+		}
+
+		constexpr auto headerSize = header.size() + sizeof(std::uint32_t) * 5;
 	}
 
 	template<typename Container, typename CSFStringEmplacer, typename Range>
@@ -145,7 +413,8 @@ namespace MyCSF {
 		auto labelCount = copyBytes<std::uint32_t>(csfRange);
 
 		if(stringCount != labelCount) {
-			throw std::invalid_argument("May not be able to correctly parse CSF file: stringCount != labelCount");
+			reportInvalidData(csfRange, "May not be able to correctly parse CSF file: stringCount != labelCount");
+			return Container{};
 		}
 
 		[[maybe_unused]] auto reserved = copyBytes<std::uint32_t>(csfRange);
@@ -153,29 +422,78 @@ namespace MyCSF {
 
 		auto map = Container{};
 
-		for(auto i = std::uint32_t{0}; i < stringCount; ++i) {
-			csfStringEmplacer(map, nextString(csfRange));
+		for(auto i = std::uint32_t{0}; i < stringCount and not hasFailed(csfRange); ++i) {
+			auto string = nextString(csfRange);
+			if(not hasFailed(csfRange)) {
+				csfStringEmplacer(map, std::move(string));
+			}
 		}
 
 		//ensure EOF is reached;
 		if(csfRange.current != csfRange.end) {
-			throw std::invalid_argument("CSF EOF not reached as expected");
+			reportInvalidData(csfRange, "CSF EOF not reached as expected");
 		}
 
 		return map;
 	}
 
+	inline std::vector<std::pair<std::string, std::wstring>> readCSFParallel(Input::ContiguousReader& csf, std::size_t threadCount) {
+		using namespace Details;
+
+		readAndCheckMagic(csf, header);
+		ignore<std::uint32_t>(csf); //version
+		auto stringCount = copyBytes<std::uint32_t>(csf);
+		auto labelCount = copyBytes<std::uint32_t>(csf);
+		if(stringCount != labelCount) {
+			reportInvalidData(csf, "May not be able to correctly parse CSF file: stringCount != labelCount");
+			return {};
+		}
+		ignore<std::uint32_t>(csf); //reserved
+		ignore<std::uint32_t>(csf); //language code
+
+		//first pass: find where every string begins, only strings which can be read completely are kept
+		constexpr auto minimumStringSize = lbl.size() + sizeof(std::uint32_t) + rts.size() + sizeof(std::uint32_t);
+		auto offsets = std::vector<const char*>{};
+		if(not hasFailed(csf)) {
+			offsets.reserve(std::min<std::size_t>(stringCount, csf.remaining() / minimumStringSize));
+		}
+		for(auto i = std::uint32_t{0}; i < stringCount and not hasFailed(csf); ++i) {
+			auto stringBegin = csf.current;
+			skipString(csf);
+			if(not hasFailed(csf)) {
+				offsets.push_back(stringBegin);
+			}
+		}
+		if(csf.current != csf.end) {
+			reportInvalidData(csf, "CSF EOF not reached as expected");
+		}
+
+		//second pass: decode blocks of strings in parallel, every string has already been validated
+		constexpr auto blockSize = std::size_t{256};
+		auto strings = std::vector<std::pair<std::string, std::wstring>>(offsets.size());
+		auto blockCount = (offsets.size() + blockSize - 1) / blockSize;
+		Parallel::forEachIndex(blockCount, threadCount, [&offsets, &strings, end = csf.end](std::size_t block) {
+			auto last = std::min(offsets.size(), (block + 1) * blockSize);
+			for(auto i = block * blockSize; i < last; ++i) {
+				auto input = ContiguousReader{offsets[i], end};
+				strings[i] = nextString(input);
+			}
+		});
+		return strings;
+	}
+
 	template<typename ForwardIteratorRange, typename OutputIterator>
 	OutputIterator writeCSF(ForwardIteratorRange stringsToBeWritten, OutputIterator out) {
 		using namespace Details;
 		
-		auto count = std::distance(stringsToBeWritten.current, stringsToBeWritten.end);
+		auto count = static_cast<std::uint32_t>(std::distance(stringsToBeWritten.current, stringsToBeWritten.end));
 
 		out = writeAsBytes(out, *(header.data()), header.size());
+		out = writeAsBytes(out, version);
 		out = writeAsBytes(out, count);
 		out = writeAsBytes(out, count);
-		out = writeAsBytes(out, *(zero32Bit.data()), zero32Bit.size());
-		out = writeAsBytes(out, *(zero32Bit.data()), zero32Bit.size());
+		out = writeAsBytes(out, std::uint32_t{0});
+		out = writeAsBytes(out, std::uint32_t{0});
 
 		for(const auto& [label, string] : stringsToBeWritten.rangeForLoop()) {
 			out = writeString(label, string, out);
@@ -183,4 +501,514 @@ namespace MyCSF {
 		return out;
 	}
 
+	template<typename ForwardIteratorRange>
+	std::size_t getCSFSize(ForwardIteratorRange stringsToBeWritten) {
+		auto size = Details::headerSize;
+		for(const auto& [label, string] : stringsToBeWritten.rangeForLoop()) {
+			size += Details::getStringSize(std::string_view{label}.size(), std::wstring_view{string}.size());
+		}
+		return size;
+	}
+
+	template<typename ForwardIteratorRange>
+	std::vector<char> writeCSFToBuffer(ForwardIteratorRange stringsToBeWritten) {
+		auto buffer = std::vector<char>(getCSFSize(stringsToBeWritten));
+		writeCSF(stringsToBeWritten, buffer.data());
+		return buffer;
+	}
+
+	inline std::vector<char> overlayCSF(Input::ContiguousReader& base, std::vector<Input::ContiguousReader>& patches) {
+		using namespace Details;
+
+		auto baseHeader = base.current;
+		auto baseTable = LazyTable{base};
+		auto patchTables = std::vector<LazyTable>{};
+		patchTables.reserve(patches.size());
+		for(auto& patch : patches) {
+			patchTables.emplace_back(patch);
+		}
+		auto hasFailedReader = [](Input::ContiguousReader& reader) { return hasFailed(reader); };
+		if(hasFailed(base) or std::any_of(patches.begin(), patches.end(), hasFailedReader)) {
+			return {};
+		}
+
+		//the text of a label comes from the last patch which has it, or from fallback if none of them has it
+		auto findText = [&patchTables](std::string_view label, const LazyEntry& fallback) -> const LazyEntry& {
+			for(auto patch = patchTables.rbegin(); patch != patchTables.rend(); ++patch) {
+				if(auto entry = patch->find(label); entry != nullptr) {
+					return *entry;
+				}
+			}
+			return fallback;
+		};
+		//a string of a patch is appended if it is the first one with its label in every file
+		auto isAppended = [&baseTable, &patchTables](std::size_t patchIndex, const LazyEntry& entry) {
+			if(baseTable.find(entry.label) != nullptr or patchTables[patchIndex].find(entry.label) != &entry) {
+				return false;
+			}
+			return std::none_of(patchTables.begin(), patchTables.begin() + patchIndex, [&entry](const LazyTable& patch) {
+				return patch.find(entry.label) != nullptr;
+			});
+		};
+
+		//first pass computes the exact size, second pass copies the strings
+		auto forEachString = [&](auto function) {
+			for(const auto& entry : baseTable) {
+				function(entry.label, findText(entry.label, entry));
+			}
+			for(auto i = std::size_t{0}; i < patchTables.size(); ++i) {
+				for(const auto& entry : patchTables[i]) {
+					if(isAppended(i, entry)) {
+						function(entry.label, findText(entry.label, entry));
+					}
+				}
+			}
+		};
+		auto size = headerSize;
+		auto count = std::size_t{0};
+		forEachString([&size, &count](std::string_view label, const LazyEntry& text) {
+			size += getStringSize(label.size(), text.length);
+			++count;
+		});
+		if(count > 0xFFFFFFFF) {
+			reportInvalidData(base, "Too many strings to be written into a CSF file");
+			return {};
+		}
+
+		auto output = std::vector<char>(size);
+		//keep version, reserved field and language code of base
+		auto out = std::copy_n(baseHeader, header.size() + sizeof(std::uint32_t), output.data());
+		out = writeAsBytes(out, static_cast<std::uint32_t>(count));
+		out = writeAsBytes(out, static_cast<std::uint32_t>(count));
+		out = std::copy_n(baseHeader + header.size() + sizeof(std::uint32_t) * 3, sizeof(std::uint32_t) * 2, out);
+		forEachString([&out](std::string_view label, const LazyEntry& text) {
+			out = writeAsBytes(out, *(lbl.data()), lbl.size());
+			out = writeAsBytes(out, static_cast<std::uint32_t>(label.size()));
+			out = std::copy_n(label.data(), label.size(), out);
+			out = writeAsBytes(out, *(rts.data()), rts.size());
+			out = writeAsBytes(out, text.length);
+			out = std::copy_n(text.maskedText, std::size_t{text.length} * sizeof(std::uint16_t), out);
+		});
+		return output;
+	}
+
+	namespace Details {
+		template<typename Character>
+		constexpr unsigned foldAscii(Character character) noexcept {
+			auto value = static_cast<unsigned>(static_cast<std::make_unsigned_t<Character>>(character));
+			return (value >= 'A' and value <= 'Z') ? value - 'A' + 'a' : value;
+		}
+
+		//FNV-1a over case-folded characters
+		class LabelHasher {
+			public:
+				void add(unsigned foldedCharacter) noexcept {
+					this->value = (this->value xor foldedCharacter) * 16777619u;
+				}
+				std::uint32_t get() const noexcept { return this->value; }
+
+			private:
+				std::uint32_t value = 2166136261u;
+		};
+
+		constexpr auto emptySlot = std::uint32_t{0xFFFFFFFF};
+		constexpr auto compiledMagic = std::string_view{"CSFC"};
+		constexpr auto compiledVersion = std::uint32_t{1};
+
+		//Find the entry index of label in an open-addressing table, or emptySlot if it doesn't exist.
+		//slotAt(slot) returns the entry index stored in a slot, foldedLabelAt(index) returns the folded label of an entry.
+		template<typename Label, typename SlotAt, typename FoldedLabelAt>
+		std::uint32_t probeSlots(Label label, std::size_t slotCount, SlotAt slotAt, FoldedLabelAt foldedLabelAt) noexcept {
+			if(slotCount == 0) {
+				return emptySlot;
+			}
+			auto hasher = LabelHasher{};
+			for(auto character : label) {
+				auto folded = foldAscii(character);
+				if(folded > 0xFF) {
+					return emptySlot; //labels are made of bytes
+				}
+				hasher.add(folded);
+			}
+			auto mask = slotCount - 1;
+			for(auto slot = hasher.get() & mask; ; slot = (slot + 1) & mask) {
+				auto index = slotAt(slot);
+				if(index == emptySlot) {
+					return emptySlot;
+				}
+				auto folded = foldedLabelAt(index);
+				if(folded.size() != label.size()) {
+					continue;
+				}
+				auto isEqual = std::equal(label.begin(), label.end(), folded.begin(), [](auto character, char foldedCharacter) {
+					return foldAscii(character) == static_cast<unsigned char>(foldedCharacter);
+				});
+				if(isEqual) {
+					return index;
+				}
+			}
+		}
+
+		//Power of two which keeps the load factor of an open-addressing table at most 1/2
+		inline std::size_t getSlotCount(std::size_t entryCount) noexcept {
+			auto slotCount = std::size_t{16};
+			while(slotCount < entryCount * 2) {
+				slotCount *= 2;
+			}
+			return slotCount;
+		}
+
+		//Read the header of csf and find every string without decoding it.
+		//Only strings which can be read completely are returned, errors are reported by Input::hasFailed(csf).
+		inline std::vector<LazyEntry> scanEntries(Input::ContiguousReader& csf) {
+			readAndCheckMagic(csf, header);
+			ignore<std::uint32_t>(csf); //version
+			auto stringCount = copyBytes<std::uint32_t>(csf);
+			auto labelCount = copyBytes<std::uint32_t>(csf);
+			if(stringCount != labelCount) {
+				reportInvalidData(csf, "May not be able to correctly parse CSF file: stringCount != labelCount");
+			}
+			ignore<std::uint32_t>(csf); //reserved
+			ignore<std::uint32_t>(csf); //language code
+
+			//every string needs at least the size of its magic numbers and lengths
+			constexpr auto minimumStringSize = lbl.size() + sizeof(std::uint32_t) + rts.size() + sizeof(std::uint32_t);
+			auto entries = std::vector<LazyEntry>{};
+			if(not hasFailed(csf)) {
+				entries.reserve(std::min<std::size_t>(stringCount, csf.remaining() / minimumStringSize));
+			}
+			for(auto i = std::uint32_t{0}; i < stringCount and not hasFailed(csf); ++i) {
+				readAndCheckMagic(csf, lbl);
+				auto labelSize = copyBytes<std::uint32_t>(csf);
+				auto label = std::string_view{csf.current, std::min<std::size_t>(labelSize, csf.remaining())};
+				ignore(csf, labelSize);
+
+				readAndCheckMagic(csf, rts);
+				auto length = copyBytes<std::uint32_t>(csf);
+				auto maskedText = csf.current;
+				if(length > csf.remaining() / sizeof(std::uint16_t)) {
+					ignore(csf, csf.remaining() + 1); //reach end of data
+				}
+				ignore(csf, std::size_t{length} * sizeof(std::uint16_t));
+				if(not hasFailed(csf)) {
+					entries.push_back(LazyEntry{label, maskedText, length});
+				}
+			}
+
+			if(csf.current != csf.end) {
+				reportInvalidData(csf, "CSF EOF not reached as expected");
+			}
+			return entries;
+		}
+
+		//Convert length UTF-16 LE units into output
+		inline void widen(const char* units, std::size_t length, wchar_t* output) noexcept {
+			if constexpr(sizeof(wchar_t) == sizeof(std::uint16_t)) {
+				std::memcpy(output, units, length * sizeof(std::uint16_t));
+			}
+			else {
+				for(auto i = std::size_t{0}; i < length; ++i) {
+					auto unit = std::uint16_t{};
+					std::memcpy(&unit, units + i * sizeof(unit), sizeof(unit));
+					output[i] = static_cast<wchar_t>(unit);
+				}
+			}
+		}
+	}
+
+	inline LazyTable::LazyTable(Input::ContiguousReader& csf) {
+		using namespace Details;
+
+		this->entries = scanEntries(csf);
+		auto foldedLabelsSize = std::size_t{0};
+		for(const auto& entry : this->entries) {
+			foldedLabelsSize += entry.label.size();
+		}
+		if(foldedLabelsSize > emptySlot or this->entries.size() >= emptySlot / 2) {
+			reportInvalidData(csf, "CSF file is too large");
+		}
+		if(hasFailed(csf)) {
+			this->entries.clear();
+			return;
+		}
+
+		this->foldedLabels.reserve(foldedLabelsSize);
+		this->labelOffsets.reserve(this->entries.size());
+		for(const auto& entry : this->entries) {
+			this->labelOffsets.push_back(static_cast<std::uint32_t>(this->foldedLabels.size()));
+			for(auto character : entry.label) {
+				this->foldedLabels.push_back(static_cast<char>(foldAscii(character)));
+			}
+		}
+
+		auto slotCount = getSlotCount(this->entries.size());
+		this->slots.assign(slotCount, emptySlot);
+		for(auto i = std::uint32_t{0}; i < this->entries.size(); ++i) {
+			auto label = std::string_view{this->foldedLabels.data() + this->labelOffsets[i], this->entries[i].label.size()};
+			auto hasher = LabelHasher{};
+			for(auto character : label) {
+				hasher.add(static_cast<unsigned char>(character));
+			}
+			for(auto slot = hasher.get() & (slotCount - 1); ; slot = (slot + 1) & (slotCount - 1)) {
+				auto& index = this->slots[slot];
+				if(index == emptySlot) {
+					index = i;
+					break;
+				}
+				auto existing = std::string_view{this->foldedLabels.data() + this->labelOffsets[index], this->entries[index].label.size()};
+				if(existing == label) {
+					break; //the first one of strings with the same label is found, like readCSF into a map
+				}
+			}
+		}
+	}
+
+	template<typename Label>
+	const LazyEntry* LazyTable::findFolded(Label label) const noexcept {
+		auto slotAt = [this](std::size_t slot) { return this->slots[slot]; };
+		auto foldedLabelAt = [this](std::uint32_t index) {
+			return std::string_view{this->foldedLabels.data() + this->labelOffsets[index], this->entries[index].label.size()};
+		};
+		auto index = Details::probeSlots(label, this->slots.size(), slotAt, foldedLabelAt);
+		return index == Details::emptySlot ? nullptr : &this->entries[index];
+	}
+
+	inline const LazyEntry* LazyTable::find(std::wstring_view label) const noexcept {
+		return this->findFolded(label);
+	}
+
+	inline const LazyEntry* LazyTable::find(std::string_view label) const noexcept {
+		return this->findFolded(label);
+	}
+
+	inline std::wstring LazyTable::decode(const LazyEntry& entry) {
+		auto string = std::wstring(entry.length, L'\0');
+		Details::unmask(entry.maskedText, string.size(), string.data());
+		return string;
+	}
+
+	/*
+		Compiled table format, in little-endian
+
+		struct CompiledTable {
+			char magic[4]; //"CSFC"
+			std::uint32_t version;
+			std::uint32_t slotCount; //power of two
+			std::uint32_t entryCount;
+			std::uint32_t foldedLabelsSize;
+			std::uint32_t textLength; //in UTF-16 units
+			std::uint32_t slots[slotCount]; //entry index, or 0xFFFFFFFF if empty
+			CompiledEntry entries[entryCount];
+			char foldedLabels[foldedLabelsSize];
+			char padding[foldedLabelsSize % 2];
+			std::uint16_t text[textLength];
+		};
+	*/
+
+	inline std::vector<char> LazyTable::compile() const {
+		using namespace Details;
+		auto textLength = std::size_t{0};
+		for(const auto& entry : this->entries) {
+			textLength += entry.length;
+		}
+		if(textLength >= emptySlot) {
+			throw std::length_error("CSF strings are too long to be compiled");
+		}
+
+		auto image = std::vector<char>{};
+		image.reserve(compiledMagic.size() + sizeof(std::uint32_t) * (5 + this->slots.size())
+		              + sizeof(CompiledEntry) * this->entries.size() + this->foldedLabels.size() + 1 + textLength * sizeof(std::uint16_t));
+		auto out = std::back_inserter(image);
+		out = std::copy(compiledMagic.begin(), compiledMagic.end(), out);
+		out = writeAsBytes(out, compiledVersion);
+		out = writeAsBytes(out, static_cast<std::uint32_t>(this->slots.size()));
+		out = writeAsBytes(out, static_cast<std::uint32_t>(this->entries.size()));
+		out = writeAsBytes(out, static_cast<std::uint32_t>(this->foldedLabels.size()));
+		out = writeAsBytes(out, static_cast<std::uint32_t>(textLength));
+		for(auto slot : this->slots) {
+			out = writeAsBytes(out, slot);
+		}
+		auto textOffset = std::uint32_t{0};
+		for(auto i = std::size_t{0}; i < this->entries.size(); ++i) {
+			const auto& entry = this->entries[i];
+			out = writeAsBytes(out, CompiledEntry{this->labelOffsets[i], static_cast<std::uint32_t>(entry.label.size()), textOffset, entry.length});
+			textOffset += entry.length;
+		}
+		out = std::copy(this->foldedLabels.begin(), this->foldedLabels.end(), out);
+		if(this->foldedLabels.size() % 2 != 0) {
+			image.push_back('\0');
+		}
+
+		//masking is a bitwise not of every byte, so the text can be unmasked after being copied
+		auto textBegin = image.size();
+		for(const auto& entry : this->entries) {
+			image.insert(image.end(), entry.maskedText, entry.maskedText + std::size_t{entry.length} * sizeof(std::uint16_t));
+		}
+		std::transform(image.begin() + textBegin, image.end(), image.begin() + textBegin, [](char byte) {
+			return static_cast<char>(compl byte);
+		});
+		return image;
+	}
+
+	inline CompiledTable::CompiledTable(Input::ContiguousReader& image) {
+		using namespace Details;
+
+		if(reinterpret_cast<std::uintptr_t>(image.current) % alignof(std::uint32_t) != 0) {
+			reportInvalidData(image, "Compiled table is not aligned");
+		}
+		readAndCheckMagic(image, compiledMagic);
+		if(copyBytes<std::uint32_t>(image) != compiledVersion) {
+			reportInvalidData(image, "Unsupported compiled table version");
+		}
+		auto slotCount = std::size_t{copyBytes<std::uint32_t>(image)};
+		auto entryCount = std::size_t{copyBytes<std::uint32_t>(image)};
+		auto foldedLabelsSize = std::size_t{copyBytes<std::uint32_t>(image)};
+		auto textLength = std::size_t{copyBytes<std::uint32_t>(image)};
+		if(slotCount == 0 or (slotCount & (slotCount - 1)) != 0 or entryCount >= slotCount) {
+			reportInvalidData(image, "Invalid compiled table size");
+		}
+		if(hasFailed(image)) {
+			return;
+		}
+
+		//check every size before multiplying it
+		if(slotCount > image.remaining() / sizeof(std::uint32_t)) {
+			image.take(image.remaining() + 1); //reach end of data
+			return;
+		}
+		auto slots = reinterpret_cast<const std::uint32_t*>(image.current);
+		image.current += slotCount * sizeof(std::uint32_t);
+		if(entryCount > image.remaining() / sizeof(CompiledEntry)) {
+			image.take(image.remaining() + 1);
+			return;
+		}
+		auto entries = reinterpret_cast<const CompiledEntry*>(image.current);
+		image.current += entryCount * sizeof(CompiledEntry);
+		auto foldedLabels = image.current;
+		ignore(image, foldedLabelsSize + foldedLabelsSize % 2);
+		auto text = image.current;
+		if(textLength > image.remaining() / sizeof(std::uint16_t)) {
+			image.take(image.remaining() + 1);
+			return;
+		}
+		image.current += textLength * sizeof(std::uint16_t);
+		if(image.current != image.end) {
+			reportInvalidData(image, "Compiled table EOF not reached as expected");
+		}
+
+		//an empty slot is needed to stop probing
+		auto hasEmptySlot = false;
+		for(auto slot = std::size_t{0}; slot < slotCount and not hasFailed(image); ++slot) {
+			if(slots[slot] == emptySlot) {
+				hasEmptySlot = true;
+			}
+			else if(slots[slot] >= entryCount) {
+				reportInvalidData(image, "Invalid compiled table slot");
+			}
+		}
+		for(auto i = std::size_t{0}; i < entryCount and not hasFailed(image); ++i) {
+			const auto& entry = entries[i];
+			if(std::uint64_t{entry.labelOffset} + entry.labelSize > foldedLabelsSize
+			   or std::uint64_t{entry.textOffset} + entry.textLength > textLength) {
+				reportInvalidData(image, "Invalid compiled table entry");
+			}
+		}
+		if(not hasEmptySlot) {
+			reportInvalidData(image, "Compiled table is full");
+		}
+		if(hasFailed(image)) {
+			return;
+		}
+
+		this->slots = slots;
+		this->slotCount = slotCount;
+		this->entries = entries;
+		this->entryCount = entryCount;
+		this->foldedLabels = foldedLabels;
+		this->text = text;
+	}
+
+	template<typename Label>
+	const CompiledEntry* CompiledTable::findFolded(Label label) const noexcept {
+		auto slotAt = [this](std::size_t slot) { return this->slots[slot]; };
+		auto foldedLabelAt = [this](std::uint32_t index) {
+			const auto& entry = this->entries[index];
+			return std::string_view{this->foldedLabels + entry.labelOffset, entry.labelSize};
+		};
+		auto index = Details::probeSlots(label, this->slotCount, slotAt, foldedLabelAt);
+		return index == Details::emptySlot ? nullptr : &this->entries[index];
+	}
+
+	inline const CompiledEntry* CompiledTable::find(std::wstring_view label) const noexcept {
+		return this->findFolded(label);
+	}
+
+	inline const CompiledEntry* CompiledTable::find(std::string_view label) const noexcept {
+		return this->findFolded(label);
+	}
+
+	inline std::wstring CompiledTable::decode(const CompiledEntry& entry) const {
+		auto string = std::wstring(entry.textLength, L'\0');
+		Details::widen(this->text + std::size_t{entry.textOffset} * sizeof(std::uint16_t), string.size(), string.data());
+		return string;
+	}
+
+	inline InternedCSF::InternedCSF(Input::ContiguousReader& csf) {
+		using namespace Details;
+
+		//first pass: find every string, and the first one of identical texts by comparing their masked bytes
+		auto scanned = scanEntries(csf);
+		if(hasFailed(csf)) {
+			return;
+		}
+		auto slotCount = getSlotCount(scanned.size());
+		auto slots = std::vector<std::uint32_t>(slotCount, emptySlot);
+		auto firstIdentical = std::vector<std::uint32_t>(scanned.size());
+		auto labelsSize = std::size_t{0};
+		auto textsSize = std::size_t{0};
+		for(auto i = std::uint32_t{0}; i < scanned.size(); ++i) {
+			const auto& entry = scanned[i];
+			labelsSize += entry.label.size();
+			auto bytes = std::string_view{entry.maskedText, std::size_t{entry.length} * sizeof(std::uint16_t)};
+			auto hasher = LabelHasher{};
+			for(auto byte : bytes) {
+				hasher.add(static_cast<unsigned char>(byte));
+			}
+			for(auto slot = hasher.get() & (slotCount - 1); ; slot = (slot + 1) & (slotCount - 1)) {
+				auto& index = slots[slot];
+				if(index == emptySlot) {
+					index = i;
+					firstIdentical[i] = i;
+					textsSize += entry.length;
+					break;
+				}
+				const auto& existing = scanned[index];
+				if(existing.length == entry.length and std::equal(bytes.begin(), bytes.end(), existing.maskedText)) {
+					firstIdentical[i] = index;
+					break;
+				}
+			}
+		}
+
+		slots = std::vector<std::uint32_t>{}; //release it before the arenas are allocated
+
+		//second pass: copy every label and decode every distinct text into the arenas
+		this->labels.resize(labelsSize);
+		this->texts.resize(textsSize);
+		this->entries.reserve(scanned.size());
+		auto label = this->labels.data();
+		auto text = this->texts.data();
+		for(auto i = std::uint32_t{0}; i < scanned.size(); ++i) {
+			const auto& entry = scanned[i];
+			auto labelView = std::string_view{label, entry.label.size()};
+			label = std::copy(entry.label.begin(), entry.label.end(), label);
+			if(firstIdentical[i] != i) {
+				this->entries.push_back(InternedEntry{labelView, this->entries[firstIdentical[i]].text});
+				continue;
+			}
+			unmask(entry.maskedText, entry.length, text);
+			this->entries.push_back(InternedEntry{labelView, std::wstring_view{text, entry.length}});
+			text += entry.length;
+		}
+	}
 }
@@ -0,0 +1,421 @@
+//Command line tool for processing replays without the Control Center.
+//It only uses the portable parsers, so it can also be built and run on Linux:
+//    g++ CommandLineTool.cpp -o ra3replaytool -O2 -Wall -std=c++17
+#include <cstdint>
+#include <cstddef>
+#include <cctype>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Input.hpp"
+#include "ReplayParser.hpp"
+#include "CSFParser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+	using namespace std::string_view_literals;
+
+	constexpr auto replayExtension = ".ra3replay"sv;
+	constexpr auto replayTailExtension = ".RA3BarLauncherTail"sv;
+
+	constexpr auto usage =
+	    "Usage: ra3replaytool <command> [--rewrite] <file or directory>...\n"
+	    "       ra3replaytool csf-overlay <output.csf> <base.csf> <patch.csf>...\n"
+	    "Commands:\n"
+	    "    scan      list the replays and measure how fast their headers are parsed\n"
+	    "    verify    check whether replays end with a valid footer by reading only their first and last bytes,\n"
+	    "              exits with 1 if some of them need to be fixed\n"
+	    "    fix       repair replays without a valid footer, only the damaged tail is cut off and backed up;\n"
+	    "              with --rewrite, a repaired copy replaces the replay and the whole original is backed up\n"
+	    "    export    print replay details as tab separated UTF-8 text\n"
+	    "    csf-overlay\n"
+	    "              merge patch CSF files into a base CSF file, strings of later patches replace earlier ones,\n"
+	    "              strings which are not in the base CSF file are appended\n"sv;
+
+	using ReplaysAndMods::ReplayState;
+
+	constexpr std::string_view toString(ReplayState state) {
+		switch(state) {
+			case ReplayState::valid: return "valid"sv;
+			case ReplayState::needsFix: return "needs fix"sv;
+			default: return "not a replay"sv;
+		}
+	}
+
+	//Strings read from replays are UTF-16 code units stored in std::wstring
+	std::string toUtf8(std::wstring_view string) {
+		auto result = std::string{};
+		result.reserve(string.size());
+		for(auto i = std::size_t{0}; i < string.size(); ++i) {
+			auto codePoint = static_cast<std::uint32_t>(string[i]) bitand 0xFFFFu;
+			if(codePoint >= 0xD800 and codePoint <= 0xDBFF and i + 1 < string.size()) {
+				auto low = static_cast<std::uint32_t>(string[i + 1]) bitand 0xFFFFu;
+				if(low >= 0xDC00 and low <= 0xDFFF) {
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					++i;
+				}
+			}
+			if(codePoint >= 0xD800 and codePoint <= 0xDFFF) {
+				codePoint = 0xFFFD; //unpaired surrogate
+			}
+
+			if(codePoint < 0x80) {
+				result += static_cast<char>(codePoint);
+			}
+			else if(codePoint < 0x800) {
+				result += static_cast<char>(0xC0 bitor (codePoint >> 6));
+				result += static_cast<char>(0x80 bitor (codePoint bitand 0x3F));
+			}
+			else if(codePoint < 0x10000) {
+				result += static_cast<char>(0xE0 bitor (codePoint >> 12));
+				result += static_cast<char>(0x80 bitor ((codePoint >> 6) bitand 0x3F));
+				result += static_cast<char>(0x80 bitor (codePoint bitand 0x3F));
+			}
+			else {
+				result += static_cast<char>(0xF0 bitor (codePoint >> 18));
+				result += static_cast<char>(0x80 bitor ((codePoint >> 12) bitand 0x3F));
+				result += static_cast<char>(0x80 bitor ((codePoint >> 6) bitand 0x3F));
+				result += static_cast<char>(0x80 bitor (codePoint bitand 0x3F));
+			}
+		}
+		return result;
+	}
+
+	//Tabs and line breaks would break the exported table
+	std::string toCell(std::wstring_view string) {
+		auto cell = toUtf8(string);
+		std::replace_if(cell.begin(), cell.end(), [](char c) { return c == '\t' or c == '\r' or c == '\n'; }, ' ');
+		return cell;
+	}
+
+	std::string formatDuration(std::optional<std::uint32_t> timeCode) {
+		if(not timeCode.has_value()) {
+			return "-";
+		}
+		auto seconds = timeCode.value() / 15;
+		auto result = std::string{};
+		for(const auto count : {seconds / 3600, (seconds % 3600) / 60, seconds % 60}) {
+			auto portion = std::to_string(count);
+			result += std::string(2 - std::min<std::size_t>(2, portion.size()), '0');
+			result += portion;
+			result += ':';
+		}
+		result.pop_back();
+		return result;
+	}
+
+	bool isReplay(const fs::path& path) {
+		auto extension = path.extension().string();
+		return std::equal(extension.begin(), extension.end(), replayExtension.begin(), replayExtension.end(),
+		                  [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+	}
+
+	//Directories are not searched recursively, like the replay folder of the Game Browser
+	std::vector<fs::path> collectReplays(const std::vector<std::string>& arguments) {
+		auto replays = std::vector<fs::path> {};
+		for(const auto& argument : arguments) {
+			auto path = fs::path{argument};
+			if(fs::is_directory(path)) {
+				auto directoryReplays = std::vector<fs::path> {};
+				for(const auto& entry : fs::directory_iterator{path}) {
+					if(entry.is_regular_file() and isReplay(entry.path())) {
+						directoryReplays.emplace_back(entry.path());
+					}
+				}
+				std::sort(directoryReplays.begin(), directoryReplays.end());
+				replays.insert(replays.end(), directoryReplays.begin(), directoryReplays.end());
+			}
+			else if(fs::is_regular_file(path)) {
+				replays.emplace_back(path);
+			}
+			else {
+				throw std::runtime_error("Cannot find replay or directory " + argument);
+			}
+		}
+		return replays;
+	}
+
+	std::vector<char> readEntireFile(const fs::path& path) {
+		auto file = std::ifstream{path, std::ios::binary};
+		if(not file) {
+			throw std::runtime_error("Cannot open " + path.string());
+		}
+		auto buffer = std::vector<char>(static_cast<std::size_t>(fs::file_size(path)));
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		if(static_cast<std::size_t>(file.gcount()) != buffer.size()) {
+			throw std::runtime_error("Cannot read " + path.string());
+		}
+		return buffer;
+	}
+
+	//Only the first and the last bytes of replay are read, which is much faster than parsing the whole replay
+	//when the only thing needed is whether a replay needs to be fixed.
+	ReplayState probeReplayFile(const fs::path& path) {
+		using namespace ReplaysAndMods;
+		auto file = std::ifstream{path, std::ios::binary};
+		auto fileSize = static_cast<std::uint64_t>(fs::file_size(path));
+		auto read = [&file, &path](std::uint64_t position, std::uint64_t size) {
+			auto buffer = std::vector<char>(static_cast<std::size_t>(size));
+			file.seekg(static_cast<std::streamoff>(position));
+			file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			if(not file) {
+				throw std::runtime_error("Cannot read " + path.string());
+			}
+			return buffer;
+		};
+
+		auto head = read(0, std::min<std::uint64_t>(fileSize, replayProbeHeadSize));
+		auto tailSize = std::min<std::uint64_t>(fileSize, replayProbeTailSize);
+		auto tail = read(fileSize - tailSize, tailSize);
+		auto state = probeReplay(Input::Range{head.cbegin(), head.cend()}, Input::Range{tail.cbegin(), tail.cend()}, fileSize);
+		if(state.has_value()) {
+			return state.value();
+		}
+		//unusually long header or footer
+		auto replay = read(0, fileSize);
+		return getReplayState(Input::ContiguousReader{replay.data(), replay.data() + replay.size()});
+	}
+
+	void writeEntireFile(const fs::path& path, const char* begin, const char* end, std::ios::openmode mode = std::ios::trunc) {
+		auto file = std::ofstream{path, std::ios::binary | mode};
+		file.write(begin, end - begin);
+		file.close();
+		if(not file) {
+			throw std::runtime_error("Cannot write " + path.string());
+		}
+	}
+
+	fs::path getUnusedBackupFileName(const fs::path& fileName, std::string_view extension) {
+		auto backupFileName = fileName.string() + ".original";
+		while(fs::exists(backupFileName + std::string{extension})) {
+			backupFileName += 'l';
+		}
+		return backupFileName + std::string{extension};
+	}
+
+	int overlay(const std::vector<std::string>& arguments) {
+		auto baseFile = readEntireFile(arguments.at(1));
+		auto base = Input::ContiguousReader{baseFile.data(), baseFile.data() + baseFile.size()};
+		auto patchFiles = std::vector<std::vector<char>>{};
+		auto patches = std::vector<Input::ContiguousReader>{};
+		for(auto i = std::size_t{2}; i < arguments.size(); ++i) {
+			const auto& file = patchFiles.emplace_back(readEntireFile(arguments[i]));
+			patches.emplace_back(file.data(), file.data() + file.size());
+		}
+
+		auto output = MyCSF::overlayCSF(base, patches);
+		if(Input::hasFailed(base)) {
+			throw std::runtime_error("Failed to parse " + arguments.at(1));
+		}
+		for(auto i = std::size_t{0}; i < patches.size(); ++i) {
+			if(Input::hasFailed(patches[i])) {
+				throw std::runtime_error("Failed to parse " + arguments.at(i + 2));
+			}
+		}
+		writeEntireFile(arguments.at(0), output.data(), output.data() + output.size());
+		std::cout << "Wrote " << output.size() << " bytes to " << arguments.at(0) << '\n';
+		return 0;
+	}
+
+	int scan(const std::vector<fs::path>& replays) {
+		using namespace ReplaysAndMods;
+		using Clock = std::chrono::steady_clock;
+
+		auto parsed = std::size_t{0};
+		auto parsedBytes = std::uint64_t{0};
+		auto parseTime = Clock::duration{};
+		for(const auto& path : replays) {
+			auto replay = readEntireFile(path);
+			auto begin = Clock::now();
+			auto reader = Input::ContiguousReader{replay.data(), replay.data() + replay.size()};
+			auto details = parseReplayHeader(reader);
+			details.finalTimeCode = getFinalTimeCode(Input::ContiguousReader{replay.data(), replay.data() + replay.size()});
+			parseTime += Clock::now() - begin;
+			if(not Input::hasFailed(reader)) {
+				++parsed;
+				parsedBytes += replay.size();
+
+				std::cout << path.filename().string() << "  " << formatDuration(details.finalTimeCode) << "  "
+				          << toUtf8(details.map) << "  " << details.players.size() << " players";
+				if(not details.modName.empty()) {
+					std::cout << "  " << toUtf8(details.modName) << ' ' << toUtf8(details.modVersion);
+				}
+				std::cout << '\n';
+			}
+			else {
+				std::cout << path.filename().string() << "  " << toString(ReplayState::notAReplay) << '\n';
+			}
+		}
+
+		auto seconds = std::chrono::duration<double>{parseTime}.count();
+		std::cerr << parsed << " of " << replays.size() << " replays parsed, "
+		          << parsedBytes / (1024.0 * 1024.0) << " MB in " << seconds * 1000 << " ms";
+		if(seconds > 0) {
+			std::cerr << " (" << parsed / seconds << " replays/s, " << parsedBytes / (1024.0 * 1024.0) / seconds << " MB/s)";
+		}
+		std::cerr << '\n';
+		return 0;
+	}
+
+	int verify(const std::vector<fs::path>& replays) {
+		auto result = 0;
+		for(const auto& path : replays) {
+			auto state = probeReplayFile(path);
+			if(state != ReplayState::valid) {
+				result = 1;
+			}
+			std::cout << path.string() << '\t' << toString(state) << '\n';
+		}
+		return result;
+	}
+
+	void repairReplayInPlace(const fs::path& path, const std::vector<char>& replay) {
+		using namespace ReplaysAndMods;
+		auto repairPoint = findReplayRepairPoint(Input::ContiguousReader{replay.data(), replay.data() + replay.size()});
+		auto backupFileName = getUnusedBackupFileName(path, replayTailExtension);
+		writeEntireFile(backupFileName, repairPoint.validEnd, replay.data() + replay.size());
+
+		//the footer overwrites the damaged bytes before the file is truncated,
+		//so if it cannot be written, the replay keeps its damaged tail instead of having no end at all
+		try {
+			auto validLength = repairPoint.validEnd - replay.data();
+			auto footer = std::string{};
+			writeReplayFooter(repairPoint.lastTimeCode, std::back_inserter(footer));
+			auto file = std::fstream{path, std::ios::binary | std::ios::in | std::ios::out};
+			file.seekp(validLength);
+			file.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+			file.close();
+			if(not file) {
+				throw std::runtime_error("Cannot write " + path.string());
+			}
+			fs::resize_file(path, static_cast<std::uintmax_t>(validLength) + footer.size());
+		}
+		catch(const std::exception& error) {
+			throw std::runtime_error(std::string{error.what()} + "; the damaged tail of the replay is backed up in " + backupFileName.string());
+		}
+	}
+
+	void rewriteReplay(const fs::path& path, const std::vector<char>& replay) {
+		using namespace ReplaysAndMods;
+		auto fixed = std::vector<char> {};
+		fixReplay(Input::ContiguousReader{replay.data(), replay.data() + replay.size()}, std::back_inserter(fixed));
+
+		auto outputName = fs::path{path.string() + ".RA3BARLAUNCHER_FIX_REPLAY" + std::string{replayExtension}};
+		writeEntireFile(outputName, fixed.data(), fixed.data() + fixed.size());
+		fs::rename(path, getUnusedBackupFileName(path, replayExtension));
+		fs::rename(outputName, path);
+	}
+
+	int fix(const std::vector<fs::path>& replays, bool rewrite) {
+		auto result = 0;
+		for(const auto& path : replays) {
+			auto replay = readEntireFile(path);
+			auto state = ReplaysAndMods::getReplayState(Input::ContiguousReader{replay.data(), replay.data() + replay.size()});
+			if(state == ReplayState::needsFix) {
+				try {
+					if(rewrite) {
+						rewriteReplay(path, replay);
+					}
+					else {
+						repairReplayInPlace(path, replay);
+					}
+					std::cout << path.string() << "\tfixed\n";
+					continue;
+				}
+				catch(const std::exception& e) {
+					std::cout << path.string() << "\tcannot be fixed: " << e.what() << '\n';
+					result = 1;
+					continue;
+				}
+			}
+			if(state == ReplayState::notAReplay) {
+				result = 1;
+			}
+			std::cout << path.string() << '\t' << toString(state) << '\n';
+		}
+		return result;
+	}
+
+	int exportDetails(const std::vector<fs::path>& replays) {
+		using namespace ReplaysAndMods;
+		std::cout << "file\tstate\tduration\tfinalTimeCode\ttimeStamp\tgameVersion\tmod\tmodVersion\ttitle\tmap\tplayers\tdescription\thasCommentator\n";
+		for(const auto& path : replays) {
+			auto replay = readEntireFile(path);
+			auto reader = Input::ContiguousReader{replay.data(), replay.data() + replay.size()};
+			auto details = parseReplayHeader(reader);
+			if(Input::hasFailed(reader)) {
+				std::cout << path.string() << '\t' << toString(ReplayState::notAReplay) << '\n';
+				continue;
+			}
+			details.finalTimeCode = getFinalTimeCode(Input::ContiguousReader{replay.data(), replay.data() + replay.size()});
+
+			auto players = std::wstring{};
+			for(const auto& player : details.players) {
+				players += (players.empty() ? L"" : L", ") + player;
+			}
+			std::cout << path.string() << '\t' << toString(details.finalTimeCode ? ReplayState::valid : ReplayState::needsFix) << '\t'
+			          << formatDuration(details.finalTimeCode) << '\t'
+			          << (details.finalTimeCode ? std::to_string(details.finalTimeCode.value()) : std::string{}) << '\t'
+			          << details.timeStamp << '\t' << details.gameVersion.first << '.' << details.gameVersion.second << '\t'
+			          << toCell(details.modName) << '\t' << toCell(details.modVersion) << '\t'
+			          << toCell(details.title) << '\t' << toCell(details.map) << '\t' << toCell(players) << '\t'
+			          << toCell(details.description) << '\t' << (details.hasCommentator ? 1 : 0) << '\n';
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	auto arguments = std::vector<std::string>(argv + std::min(argc, 1), argv + argc);
+	if(arguments.empty()) {
+		std::cerr << usage;
+		return 2;
+	}
+	auto command = arguments.front();
+	arguments.erase(arguments.begin());
+
+	auto rewrite = std::find(arguments.begin(), arguments.end(), "--rewrite") != arguments.end();
+	arguments.erase(std::remove(arguments.begin(), arguments.end(), "--rewrite"), arguments.end());
+	if(arguments.empty() or (rewrite and command != "fix")) {
+		std::cerr << usage;
+		return 2;
+	}
+
+	try {
+		if(command == "csf-overlay") {
+			if(arguments.size() < 3) {
+				std::cerr << usage;
+				return 2;
+			}
+			return overlay(arguments);
+		}
+		auto replays = collectReplays(arguments);
+		if(command == "scan") {
+			return scan(replays);
+		}
+		if(command == "verify") {
+			return verify(replays);
+		}
+		if(command == "fix") {
+			return fix(replays, rewrite);
+		}
+		if(command == "export") {
+			return exportDetails(replays);
+		}
+		std::cerr << usage;
+		return 2;
+	}
+	catch(const std::exception& e) {
+		std::cerr << "Error: " << e.what() << '\n';
+		return 3;
+	}
+}
@@ -3,12 +3,18 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <iterator>
 #include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#define INPUT_HPP_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace Input {
 	template<typename Iterator>
@@ -107,4 +113,128 @@ namespace Input {
 		copyFixed(input, valueBegin, sizeof(value));
 		return value;
 	}
+
+	//Whether an error has been recorded instead of thrown, Range always throws
+	template<typename InputIterator>
+	constexpr bool hasFailed(const Range<InputIterator>&) noexcept {
+		return false;
+	}
+
+	template<typename InputIterator>
+	[[noreturn]] void reportInvalidData(Range<InputIterator>&, const char* message) {
+		throw std::invalid_argument(message);
+	}
+
+	//Reader of a contiguous byte buffer, which can be used in place of Range<const char*> with the same functions.
+	//Instead of throwing exceptions, the first error is recorded and every following read does nothing:
+	//copyBytes returns zero, ignore and copyFixed leave the reader unchanged.
+	//So a parser can read a whole structure and check hasFailed() only when the result is needed.
+	struct ContiguousReader {
+		enum class Error {
+			none,
+			endOfData,
+			magicMismatch,
+			invalidData,
+		};
+		enum { isAtLeastForwardIterator = true };
+
+		constexpr ContiguousReader(const char* current, const char* end) noexcept : current{current}, end{end} { }
+		constexpr std::size_t remaining() const noexcept { return static_cast<std::size_t>(this->end - this->current); }
+		constexpr bool take(std::size_t numberOfBytes) noexcept {
+			if(this->error != Error::none) {
+				return false;
+			}
+			if(this->remaining() < numberOfBytes) {
+				this->error = Error::endOfData;
+				return false;
+			}
+			return true;
+		}
+
+		const char* current;
+		const char* end;
+		Error error = Error::none;
+	};
+
+	constexpr bool hasFailed(const ContiguousReader& reader) noexcept {
+		return reader.error != ContiguousReader::Error::none;
+	}
+
+	inline void reportInvalidData(ContiguousReader& reader, const char*) noexcept {
+		if(reader.error == ContiguousReader::Error::none) {
+			reader.error = ContiguousReader::Error::invalidData;
+		}
+	}
+
+	inline void readAndCheckMagic(ContiguousReader& reader, std::string_view magic) noexcept {
+		if(not reader.take(magic.size())) {
+			return;
+		}
+		if(std::memcmp(reader.current, magic.data(), magic.size()) != 0) {
+			reader.error = ContiguousReader::Error::magicMismatch;
+			return;
+		}
+		reader.current += magic.size();
+	}
+
+	template<typename OutputIterator>
+	void copyFixed(ContiguousReader& reader, OutputIterator outputBegin, std::size_t count) {
+		if(not reader.take(count)) {
+			return;
+		}
+		std::copy_n(reader.current, count, outputBegin);
+		reader.current += count;
+	}
+
+	inline void ignore(ContiguousReader& reader, std::size_t numberOfBytes) noexcept {
+		if(reader.take(numberOfBytes)) {
+			reader.current += numberOfBytes;
+		}
+	}
+
+	template<typename T>
+	void ignore(ContiguousReader& reader) noexcept {
+		ignore(reader, sizeof(T));
+	}
+
+	//Values are loaded with memcpy, in the byte order of the machine, just like copyBytes of Range
+	template<typename T>
+	T copyBytes(ContiguousReader& reader) noexcept {
+		static_assert(std::is_trivially_copyable_v<T>);
+		auto value = T{};
+		if(reader.take(sizeof(value))) {
+			std::memcpy(&value, reader.current, sizeof(value));
+			reader.current += sizeof(value);
+		}
+		return value;
+	}
+
+	//Find the first 16-bit zero in [begin, end), 16-bit units are counted from begin.
+	//Return end if there isn't any.
+	inline const char* findNull16Scalar(const char* begin, const char* end) noexcept {
+		for(; end - begin >= 2; begin += 2) {
+			if(begin[0] == 0 and begin[1] == 0) {
+				return begin;
+			}
+		}
+		return end;
+	}
+
+	inline const char* findNull16(const char* begin, const char* end) noexcept {
+#ifdef INPUT_HPP_USE_SSE2
+		const auto zero = _mm_setzero_si128();
+		for(; end - begin >= 16; begin += 16) {
+			auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(units, zero));
+			if(mask != 0) {
+				auto index = 0;
+				while(((mask >> index) bitand 1) == 0) {
+					++index;
+				}
+				return begin + index;
+			}
+		}
+#endif
+		return findNull16Scalar(begin, end);
+	}
 }
@@ -0,0 +1,184 @@
+//Order of the rows of a list (such as the replay list of the Game Browser),
+//which can be sorted by one or more columns without moving the data of rows.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+//Rows are indices into the data of a list, rows hidden by a filter are skipped.
+//The ascending order of a column and the rank of every row in it are computed once and cached until rows are changed,
+//so reversing the sort direction only reverses the cached order, and sorting by several columns only compares ranks.
+class ListOrder {
+	public:
+		struct SortKey {
+			std::size_t column;
+			bool descending;
+		};
+
+		//Number of shown rows
+		std::size_t size() const noexcept { return this->rows.size(); }
+		//Index of the data shown at row
+		std::size_t at(std::size_t row) const { return this->rows.at(row); }
+		const std::vector<SortKey>& sortKeys() const noexcept { return this->keys; }
+
+		//Data is replaced by count new rows, shown in their original order
+		void reset(std::size_t count) {
+			this->rowCount = count;
+			this->rows.resize(count);
+			std::iota(this->rows.begin(), this->rows.end(), std::size_t{0});
+			this->columns.clear();
+			this->keys.clear();
+			this->filtered = false;
+			this->shown.clear();
+		}
+
+		//New rows are added after the existing ones, they stay at the end until the list is sorted again.
+		//If the list is filtered, only new rows for which isShown(index) is true are shown.
+		template<typename IsShown>
+		void append(std::size_t newRowCount, IsShown isShown) {
+			auto oldCount = this->rowCount;
+			this->rowCount += newRowCount;
+			for(auto index = oldCount; index < this->rowCount; ++index) {
+				if(this->isFiltered()) {
+					this->shown.push_back(isShown(index));
+				}
+				if(this->isShown(index)) {
+					this->rows.push_back(index);
+				}
+			}
+			this->columns.clear();
+		}
+
+		void append(std::size_t newRowCount) {
+			this->append(newRowCount, [](std::size_t) { return true; });
+		}
+
+		bool isFiltered() const noexcept { return this->filtered; }
+
+		//Only show the rows whose indices are in shownIndices (in ascending order), keeping the current sort keys
+		template<typename Less>
+		void filter(const std::vector<std::size_t>& shownIndices, Less less) {
+			this->filtered = true;
+			this->shown.assign(this->rowCount, false);
+			for(auto index : shownIndices) {
+				this->shown.at(index) = true;
+			}
+			this->sort(less);
+		}
+
+		//Show all rows again
+		template<typename Less>
+		void clearFilter(Less less) {
+			this->filtered = false;
+			this->shown.clear();
+			this->sort(less);
+		}
+
+		//Sort by column only, or reverse the list if it's already sorted by column only.
+		//If addToKeys is true, column becomes the last sort key, or its direction is reversed if it's already a key.
+		//less(column, a, b) compares the data of a and b in column, it's only called when a column isn't cached.
+		template<typename Less>
+		void sortBy(std::size_t column, bool addToKeys, Less less) {
+			auto key = std::find_if(this->keys.begin(), this->keys.end(), [column](const SortKey& key) { return key.column == column; });
+			if(addToKeys) {
+				if(key != this->keys.end()) {
+					key->descending = not key->descending;
+				}
+				else {
+					this->keys.push_back(SortKey{column, false});
+				}
+			}
+			else {
+				auto descending = (this->keys.size() == 1 and key != this->keys.end()) ? not key->descending : false;
+				this->keys.assign(1, SortKey{column, descending});
+			}
+			this->sort(less);
+		}
+
+		//Sort again by the current sort keys, for example after rows have been appended
+		template<typename Less>
+		void sort(Less less) {
+			auto isShown = [this](std::size_t index) { return this->isShown(index); };
+			this->rows.clear();
+			if(this->keys.empty()) {
+				for(auto index = std::size_t{0}; index < this->rowCount; ++index) {
+					if(isShown(index)) {
+						this->rows.push_back(index);
+					}
+				}
+				return;
+			}
+			for(const auto& key : this->keys) {
+				this->cache(key.column, less);
+			}
+
+			if(this->keys.size() == 1) {
+				const auto& [column, descending] = this->keys.front();
+				const auto& ascending = this->columns[column].ascending;
+				if(descending) {
+					std::copy_if(ascending.rbegin(), ascending.rend(), std::back_inserter(this->rows), isShown);
+				}
+				else {
+					std::copy_if(ascending.begin(), ascending.end(), std::back_inserter(this->rows), isShown);
+				}
+				return;
+			}
+
+			for(auto index = std::size_t{0}; index < this->rowCount; ++index) {
+				if(isShown(index)) {
+					this->rows.push_back(index);
+				}
+			}
+			std::stable_sort(this->rows.begin(), this->rows.end(), [this](std::size_t a, std::size_t b) {
+				for(const auto& [column, descending] : this->keys) {
+					const auto& ranks = this->columns[column].ranks;
+					if(ranks[a] != ranks[b]) {
+						return descending ? ranks[b] < ranks[a] : ranks[a] < ranks[b];
+					}
+				}
+				return false;
+			});
+		}
+
+	private:
+		struct Column {
+			bool cached = false;
+			std::vector<std::size_t> ascending; //stable, rows which are equal keep their original order
+			std::vector<std::size_t> ranks;     //rank of every row in ascending order, rows which are equal have the same rank
+		};
+
+		bool isShown(std::size_t index) const { return not this->filtered or this->shown[index]; }
+
+		template<typename Less>
+		void cache(std::size_t column, Less& less) {
+			if(column >= this->columns.size()) {
+				this->columns.resize(column + 1);
+			}
+			auto& cached = this->columns[column];
+			if(cached.cached) {
+				return;
+			}
+			auto isLess = [column, &less](std::size_t a, std::size_t b) { return less(column, a, b); };
+			cached.ascending.resize(this->rowCount);
+			std::iota(cached.ascending.begin(), cached.ascending.end(), std::size_t{0});
+			std::stable_sort(cached.ascending.begin(), cached.ascending.end(), isLess);
+
+			cached.ranks.resize(this->rowCount);
+			for(auto i = std::size_t{0}; i < cached.ascending.size(); ++i) {
+				auto row = cached.ascending[i];
+				auto isTie = i > 0 and not isLess(cached.ascending[i - 1], row);
+				cached.ranks[row] = isTie ? cached.ranks[cached.ascending[i - 1]] : i;
+			}
+			cached.cached = true;
+		}
+
+		std::size_t rowCount = 0;           //including hidden rows
+		std::vector<std::size_t> rows;      //shown rows, in display order
+		std::vector<Column> columns;        //for all rows, including hidden ones
+		std::vector<SortKey> keys;
+		bool filtered = false;
+		std::vector<bool> shown;            //empty if the list isn't filtered
+};
@@ -0,0 +1,140 @@
+//A small work-stealing scheduler used to spread independent jobs
+//(such as parsing replay headers) across all cores.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+	inline std::size_t defaultThreadCount() {
+		auto count = std::thread::hardware_concurrency();
+		return count == 0 ? 1 : count;
+	}
+
+	//Call function(index) for every index in [0, count) with at most threadCount threads.
+	//Every thread owns a contiguous range of indices and takes jobs from its front;
+	//a thread which runs out of jobs steals the back half of the largest remaining range.
+	//If threadCount <= 1, all jobs run on the calling thread in index order.
+	//If function throws, remaining jobs are abandoned and the first exception is rethrown.
+	template<typename Function>
+	void forEachIndex(std::size_t count, std::size_t threadCount, Function function);
+
+	namespace Details {
+		struct WorkRange {
+			std::mutex mutex;
+			std::size_t begin = 0;
+			std::size_t end = 0;
+		};
+
+		inline bool takeOwnJob(WorkRange& range, std::size_t& job) {
+			auto lock = std::lock_guard{range.mutex};
+			if(range.begin == range.end) {
+				return false;
+			}
+			job = range.begin++;
+			return true;
+		}
+
+		inline bool stealJobs(std::vector<WorkRange>& ranges, WorkRange& thief) {
+			while(true) {
+				auto victim = static_cast<WorkRange*>(nullptr);
+				auto victimSize = std::size_t{0};
+				for(auto& range : ranges) {
+					auto lock = std::lock_guard{range.mutex};
+					if(range.end - range.begin > victimSize) {
+						victim = &range;
+						victimSize = range.end - range.begin;
+					}
+				}
+				if(victim == nullptr) {
+					return false;
+				}
+
+				auto victimLock = std::unique_lock{victim->mutex};
+				auto remaining = victim->end - victim->begin;
+				if(remaining == 0) {
+					continue; //someone else took them first, look for another victim
+				}
+				auto stolenBegin = victim->end - (remaining + 1) / 2;
+				auto stolenEnd = victim->end;
+				victim->end = stolenBegin;
+				victimLock.unlock();
+
+				auto thiefLock = std::lock_guard{thief.mutex};
+				thief.begin = stolenBegin;
+				thief.end = stolenEnd;
+				return true;
+			}
+		}
+	}
+
+	template<typename Function>
+	void forEachIndex(std::size_t count, std::size_t threadCount, Function function) {
+		threadCount = std::min(threadCount, count);
+		if(threadCount <= 1) {
+			for(auto i = std::size_t{0}; i < count; ++i) {
+				function(i);
+			}
+			return;
+		}
+
+		auto ranges = std::vector<Details::WorkRange>(threadCount);
+		for(auto i = std::size_t{0}; i < threadCount; ++i) {
+			ranges[i].begin = count * i / threadCount;
+			ranges[i].end = count * (i + 1) / threadCount;
+		}
+
+		auto failed = std::atomic<bool>{false};
+		auto firstException = std::exception_ptr{};
+		auto exceptionMutex = std::mutex{};
+
+		auto worker = [&ranges, &failed, &firstException, &exceptionMutex, &function](std::size_t self) {
+			auto& ownRange = ranges[self];
+			auto job = std::size_t{0};
+			try {
+				while(not failed.load(std::memory_order_relaxed)) {
+					if(not Details::takeOwnJob(ownRange, job)) {
+						if(Details::stealJobs(ranges, ownRange)) {
+							continue;
+						}
+						return;
+					}
+					function(job);
+				}
+			}
+			catch(...) {
+				auto lock = std::lock_guard{exceptionMutex};
+				if(not firstException) {
+					firstException = std::current_exception();
+				}
+				failed = true;
+			}
+		};
+
+		auto threads = std::vector<std::thread> {};
+		threads.reserve(threadCount - 1);
+		try {
+			for(auto i = std::size_t{1}; i < threadCount; ++i) {
+				threads.emplace_back(worker, i);
+			}
+		}
+		catch(...) {
+			//cannot start more threads, those already started will also take over the remaining jobs
+		}
+		worker(0);
+		for(auto& thread : threads) {
+			thread.join();
+		}
+
+		if(firstException) {
+			std::rethrow_exception(firstException);
+		}
+	}
+}
@@ -0,0 +1,466 @@
+//Replay parsing functions which don't depend on Windows.
+//They only need the utility functions of 'Input.hpp', and can be used by command line tools as well.
+//Strings read from replays are stored in std::wstring as UTF-16 code units,
+//even on platforms where wchar_t is 32 bits wide.
+#pragma once
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "Input.hpp"
+
+namespace ReplaysAndMods {
+
+	struct ReplayDetails {
+		std::wstring fullPath;
+		std::wstring replayName;
+		std::optional<std::uint32_t> finalTimeCode;
+		std::wstring modName;
+		std::wstring modVersion;
+		std::pair<std::uint32_t, std::uint32_t> gameVersion;
+		std::uint32_t timeStamp;
+		std::wstring title;
+		std::wstring map;
+		std::vector<std::wstring> players;
+		std::wstring description;
+		bool hasCommentator;
+	};
+
+	enum class ReplayState {
+		valid,
+		needsFix,
+		notAReplay,
+	};
+
+	template<typename Range>
+	ReplayDetails parseReplayHeader(Range&& replay);
+	template<typename Range>
+	auto findReplayRepairPoint(Range&& replay);
+	template<typename OutputIterator>
+	OutputIterator writeReplayFooter(const std::array<char, sizeof(std::uint32_t)>& lastTimeCode, OutputIterator output);
+	template<typename Range, typename OutputIterator>
+	OutputIterator fixReplay(Range&& replay, OutputIterator output);
+	template<typename Range>
+	std::optional<std::uint32_t> getFinalTimeCodeFromLastBytes(Range&& terminatorAndFooter);
+	template<typename Range>
+	std::optional<std::uint32_t> getFinalTimeCode(Range&& replay);
+	template<typename Range>
+	ReplayState getReplayState(Range&& replay);
+	template<typename HeadRange, typename TailRange>
+	std::optional<ReplayState> probeReplay(HeadRange&& head, TailRange&& tail, std::uint64_t replaySize);
+
+	inline constexpr auto replayHeaderMagic = std::string_view {"RA3 REPLAY HEADER"};
+	//Headers and footers written by the game are much shorter than these, so probeReplay rarely needs more bytes
+	inline constexpr auto replayProbeHeadSize = std::size_t{4096};
+	inline constexpr auto replayProbeTailSize = std::size_t{512};
+	//A longer footer length can only come from a damaged replay
+	inline constexpr auto replayMaxFooterSize = std::size_t{65536};
+	namespace Internal {
+		using namespace Input;
+		using namespace std::string_view_literals;
+
+		inline constexpr auto cncMagic = std::string_view {"CNC3RPL\0"sv};
+		inline constexpr auto terminator = std::string_view {"\xFF\xFF\xFF\x7F"sv};
+		inline constexpr auto footerMagic = std::string_view {"RA3 REPLAY FOOTER"sv};
+		inline constexpr auto prePlainTextPadding = 31;
+
+		//Decode UTF-8 into UTF-16 code units, invalid sequences are replaced with U+FFFD
+		inline std::wstring widenUtf8(std::string_view bytes) {
+			constexpr auto replacement = wchar_t{0xFFFD};
+			auto result = std::wstring{};
+			result.reserve(bytes.size());
+			for(auto i = std::size_t{0}; i < bytes.size(); ) {
+				auto lead = static_cast<unsigned char>(bytes[i]);
+				auto length = (lead < 0x80) ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+				if(length == 0 or bytes.size() - i < static_cast<std::size_t>(length)) {
+					result += replacement;
+					++i;
+					continue;
+				}
+
+				auto codePoint = std::uint32_t{lead} bitand (0xFFu >> (length == 1 ? 1 : length + 1));
+				auto valid = true;
+				for(auto k = 1; k < length; ++k) {
+					auto continuation = static_cast<unsigned char>(bytes[i + k]);
+					valid = valid and ((continuation >> 6) == 0x02);
+					codePoint = (codePoint << 6) bitor (continuation bitand 0x3Fu);
+				}
+				constexpr auto minimumCodePoints = std::array<std::uint32_t, 5>{0, 0, 0x80, 0x800, 0x10000};
+				valid = valid and codePoint >= minimumCodePoints[length] and codePoint <= 0x10FFFF
+				        and not (codePoint >= 0xD800 and codePoint <= 0xDFFF);
+				if(not valid) {
+					result += replacement;
+					++i;
+					continue;
+				}
+
+				if(codePoint >= 0x10000) {
+					codePoint -= 0x10000;
+					result += static_cast<wchar_t>(0xD800 + (codePoint >> 10));
+					result += static_cast<wchar_t>(0xDC00 + (codePoint bitand 0x3FF));
+				}
+				else {
+					result += static_cast<wchar_t>(codePoint);
+				}
+				i += length;
+			}
+			return result;
+		}
+
+		template<typename Reader>
+		std::wstring readNullTerminatedWideString(Reader& input) {
+			auto result = std::wstring {};
+			do {
+				result += static_cast<wchar_t>(copyBytes<std::uint16_t>(input));
+			}
+			while(result.back() != L'\0');
+			result.pop_back();
+			return result;
+		}
+
+		template<typename Reader>
+		void skipNullTerminatedWideString(Reader& input) {
+			while(copyBytes<std::uint16_t>(input) != 0) { }
+		}
+
+		//Contiguous buffers are scanned for the terminator first, then the whole string is copied at once
+		inline const char* findWideStringTerminator(ContiguousReader& input) noexcept {
+			if(hasFailed(input)) {
+				return nullptr;
+			}
+			auto terminatorPosition = findNull16(input.current, input.end);
+			if(terminatorPosition == input.end) {
+				input.error = ContiguousReader::Error::endOfData;
+				return nullptr;
+			}
+			return terminatorPosition;
+		}
+
+		inline std::wstring readNullTerminatedWideString(ContiguousReader& input) {
+			auto terminatorPosition = findWideStringTerminator(input);
+			if(terminatorPosition == nullptr) {
+				return {};
+			}
+			auto result = std::wstring(static_cast<std::size_t>(terminatorPosition - input.current) / sizeof(std::uint16_t), L'\0');
+			if constexpr(sizeof(wchar_t) == sizeof(std::uint16_t)) {
+				std::memcpy(result.data(), input.current, result.size() * sizeof(std::uint16_t));
+			}
+			else {
+				auto unit = input.current;
+				for(auto& character : result) {
+					auto value = std::uint16_t{};
+					std::memcpy(&value, unit, sizeof(value));
+					character = static_cast<wchar_t>(value);
+					unit += sizeof(value);
+				}
+			}
+			input.current = terminatorPosition + sizeof(std::uint16_t);
+			return result;
+		}
+
+		inline void skipNullTerminatedWideString(ContiguousReader& input) noexcept {
+			auto terminatorPosition = findWideStringTerminator(input);
+			if(terminatorPosition != nullptr) {
+				input.current = terminatorPosition + sizeof(std::uint16_t);
+			}
+		}
+
+		//Advance replay to the first chunk, without parsing any header field that is not needed to do so
+		template<typename Reader>
+		void skipReplayHeader(Reader& replay) {
+			readAndCheckMagic(replay, replayHeaderMagic);
+			auto hNumber = copyBytes<char>(replay);
+			ignore(replay, sizeof(std::uint32_t) * 4 + sizeof(char) * 2); //version numbers and flags
+
+			for(auto i = 0; i < 4; ++i) {
+				skipNullTerminatedWideString(replay); //title, description, map name and map ID
+			}
+
+			auto numberOfPlayers = copyBytes<unsigned char>(replay);
+			for(auto i = 0; i < numberOfPlayers + 1; ++i) {
+				ignore<std::uint32_t>(replay); //player id
+				skipNullTerminatedWideString(replay);
+				if(hNumber == 0x05) {
+					ignore<char>(replay); //team number
+				}
+			}
+
+			auto offset = copyBytes<std::uint32_t>(replay);
+			ignore<std::uint32_t>(replay); //CNC3RPL magic length
+			readAndCheckMagic(replay, cncMagic);
+			ignore(replay, offset - cncMagic.size());
+		}
+	}
+
+	template<typename Range>
+	ReplayDetails parseReplayHeader(Range&& replay) {
+		using namespace Internal;
+
+		readAndCheckMagic(replay, replayHeaderMagic);
+
+		auto hNumber = std::to_integer<unsigned>(copyBytes<std::byte>(replay));
+
+		auto majorVersion = copyBytes<std::uint32_t>(replay);
+		auto minorVersion = copyBytes<std::uint32_t>(replay);
+		auto gameVersion = std::pair{majorVersion, minorVersion};
+
+		ignore<std::uint32_t>(replay); //build major
+		ignore<std::uint32_t>(replay); //build minor
+		ignore<std::byte>(replay);  //commentary track flag?
+		ignore<std::byte>(replay);  //zero
+
+		auto title = readNullTerminatedWideString(replay);
+		auto description = readNullTerminatedWideString(replay);
+		auto mapName = readNullTerminatedWideString(replay);
+		auto mapID = readNullTerminatedWideString(replay);
+
+		auto numberOfPlayers = std::to_integer<std::size_t>(copyBytes<std::byte>(replay));
+
+		auto playerNames = std::vector<std::wstring> {numberOfPlayers + 1, {}, std::vector<std::wstring>::allocator_type{}};
+		for(auto& playerName : playerNames) {
+			ignore<std::uint32_t>(replay); //skip player id
+			playerName = readNullTerminatedWideString(replay);
+			if(hNumber == 0x05u) {
+				ignore<std::byte>(replay); //skip team number
+			}
+		}
+		playerNames.pop_back();
+
+		auto offset = copyBytes<std::uint32_t>(replay);
+
+		if(copyBytes<std::uint32_t>(replay) != cncMagic.size()) {
+			reportInvalidData(replay, "incorrect CNC3RPL magic length");
+		}
+		readAndCheckMagic(replay, cncMagic);
+
+		constexpr auto modInfoSize = std::size_t{22};
+		auto modInfo = std::string{modInfoSize, {}, std::string::allocator_type{}};
+		copyFixed(replay, modInfo.begin(), modInfo.size());
+		auto modVersion = modInfo.substr(modInfo.find_last_of('\0', modInfo.find_last_not_of('\0')) + 1);
+		modInfo.resize(std::min(modInfo.size(), modInfo.find('\0')));
+		modVersion.resize(std::min(modVersion.size(), modVersion.find('\0')));
+
+		auto timeStamp = copyBytes<std::uint32_t>(replay);
+
+		ignore(replay, prePlainTextPadding);
+		auto plainTextLength = copyBytes<std::uint32_t>(replay);
+		auto plainText = std::string{plainTextLength, {}, std::string::allocator_type{}};
+		copyFixed(replay, plainText.begin(), plainTextLength);
+
+		auto hasCommentator = (plainText.rfind(":Hpost Commentator") != plainText.npos);
+
+		auto afterOffset = cncMagic.size() + modInfo.size() + sizeof(timeStamp)
+		                   + prePlainTextPadding + sizeof(plainTextLength) + plainText.size();
+		ignore(replay, offset - afterOffset);
+
+		using std::move;
+		return {{}, {}, std::nullopt, widenUtf8(modInfo), widenUtf8(modVersion), gameVersion, timeStamp,
+			move(title), move(mapName), move(playerNames), move(description), hasCommentator};
+	}
+
+	template<typename Iterator>
+	struct ReplayRepairPoint {
+		Iterator validEnd; //end of the last complete chunk, or end of replay if the footer is valid
+		bool hasValidFooter;
+		std::array<char, sizeof(std::uint32_t)> lastTimeCode;
+	};
+
+	//Find out how much of a replay can be kept as it is.
+	//Header and every complete chunk are kept; if the replay doesn't end with a valid footer,
+	//everything after the last complete chunk is damaged and must be replaced by a generated footer.
+	template<typename Range>
+	auto findReplayRepairPoint(Range&& replay) {
+		using namespace Internal;
+		using Iterator = decltype(replay.current);
+		static_assert(std::decay_t<Range>::isAtLeastForwardIterator, "chunks are kept only after they have been validated");
+
+		skipReplayHeader(replay);
+		if(hasFailed(replay)) {
+			throw std::invalid_argument("Failed to parse replay header");
+		}
+
+		auto repairPoint = ReplayRepairPoint<Iterator>{replay.current, false, {}};
+		try {
+			while(true) {
+				auto chunkBegin = replay.current;
+				auto chunkTimeCode = decltype(repairPoint.lastTimeCode) {};
+				copyFixed(replay, std::begin(chunkTimeCode), chunkTimeCode.size());
+				if(hasFailed(replay)) {
+					break;
+				}
+				if(std::equal(std::begin(chunkTimeCode), std::end(chunkTimeCode),
+				              std::begin(terminator), std::end(terminator))) {
+					if(getFinalTimeCodeFromLastBytes(std::decay_t<Range>{chunkBegin, replay.end}).has_value()) {
+						repairPoint.validEnd = replay.end;
+						repairPoint.hasValidFooter = true;
+					}
+					return repairPoint;
+				}
+
+				ignore<char>(replay); //chunk type
+				auto chunkSize = copyBytes<std::uint32_t>(replay);
+				ignore(replay, chunkSize);
+				readAndCheckMagic(replay, "\0\0\0\0"sv);
+				if(hasFailed(replay)) {
+					break;
+				}
+
+				repairPoint.validEnd = replay.current;
+				repairPoint.lastTimeCode = chunkTimeCode;
+			}
+		}
+		catch(...) { }
+		return repairPoint;
+	}
+
+	//Write terminator and a footer whose final time code is lastTimeCode
+	template<typename OutputIterator>
+	OutputIterator writeReplayFooter(const std::array<char, sizeof(std::uint32_t)>& lastTimeCode, OutputIterator output) {
+		using namespace Internal;
+		constexpr auto finalData = std::string_view{"\x02\x1A\x00\x00\x00"sv};
+		auto footerLength = static_cast<std::uint32_t>(terminator.size() + footerMagic.size() + lastTimeCode.size() + finalData.size());
+		output = std::copy(std::begin(terminator), std::end(terminator), output);
+		output = std::copy(std::begin(footerMagic), std::end(footerMagic), output);
+		output = std::copy(std::begin(lastTimeCode), std::end(lastTimeCode), output);
+		output = std::copy(std::begin(finalData), std::end(finalData), output);
+		return std::copy_n(reinterpret_cast<const char*>(&footerLength), sizeof(footerLength), output);
+	}
+
+	//Write the repaired replay into output.
+	template<typename Range, typename OutputIterator>
+	OutputIterator fixReplay(Range&& replay, OutputIterator output) {
+		auto replayBegin = replay.current;
+		auto repairPoint = findReplayRepairPoint(replay);
+		output = std::copy(replayBegin, repairPoint.validEnd, output);
+		if(repairPoint.hasValidFooter) {
+			return output;
+		}
+		return writeReplayFooter(repairPoint.lastTimeCode, output);
+	}
+
+	template<typename Range>
+	std::optional<std::uint32_t> getFinalTimeCodeFromLastBytes(Range&& terminatorAndFooter) {
+		using namespace Internal;
+		static_assert(std::decay_t<Range>::isAtLeastForwardIterator, "footer length is stored at the end of footer");
+		using Reader = std::decay_t<Range>;
+		try {
+			readAndCheckMagic(terminatorAndFooter, terminator);
+			readAndCheckMagic(terminatorAndFooter, footerMagic);
+			auto finalTimeCode = copyBytes<std::uint32_t>(terminatorAndFooter);
+			if(hasFailed(terminatorAndFooter)) {
+				return std::nullopt;
+			}
+
+			auto remainedBytes = std::distance(terminatorAndFooter.current, terminatorAndFooter.end);
+			if(remainedBytes < static_cast<decltype(remainedBytes)>(sizeof(std::uint32_t))) {
+				return std::nullopt;
+			}
+			auto footerLengthRange = Reader{std::next(terminatorAndFooter.current, remainedBytes - sizeof(std::uint32_t)), terminatorAndFooter.end};
+			auto footerLength = copyBytes<std::uint32_t>(footerLengthRange);
+			if(std::uint64_t{footerLength} + terminator.size() > replayMaxFooterSize) {
+				return std::nullopt;
+			}
+			if((footerLength - footerMagic.size() - sizeof(finalTimeCode)) != static_cast<std::uint64_t>(remainedBytes)) {
+				return std::nullopt; //incorrect footer length
+			}
+			return finalTimeCode;
+		}
+		catch(...) { }
+		return std::nullopt;
+	}
+
+	//The footer length is stored in the last 4 bytes of a replay, which is used to locate its terminator and footer
+	template<typename Range>
+	std::optional<std::uint32_t> getFinalTimeCode(Range&& replay) {
+		using namespace Internal;
+		static_assert(std::decay_t<Range>::isAtLeastForwardIterator, "footer length is stored at the end of replay");
+		using Reader = std::decay_t<Range>;
+		using Difference = typename std::iterator_traits<decltype(replay.current)>::difference_type;
+
+		auto replaySize = static_cast<std::uint64_t>(std::distance(replay.current, replay.end));
+		if(replaySize < sizeof(std::uint32_t)) {
+			return std::nullopt;
+		}
+		auto footerLengthRange = Reader{std::next(replay.current, static_cast<Difference>(replaySize - sizeof(std::uint32_t))), replay.end};
+		auto footerLength = copyBytes<std::uint32_t>(footerLengthRange);
+
+		auto terminatorAndFooterLength = std::uint64_t{footerLength} + terminator.size();
+		if(terminatorAndFooterLength > replaySize or terminatorAndFooterLength > replayMaxFooterSize) {
+			return std::nullopt;
+		}
+		auto lastBytes = Reader{std::next(replay.current, static_cast<Difference>(replaySize - terminatorAndFooterLength)), replay.end};
+		return getFinalTimeCodeFromLastBytes(lastBytes);
+	}
+
+	//Replays whose header can be parsed are either valid or can be fixed by fixReplay
+	template<typename Range>
+	ReplayState getReplayState(Range&& replay) {
+		using namespace Internal;
+		static_assert(std::decay_t<Range>::isAtLeastForwardIterator, "footer length is stored at the end of replay");
+		auto header = replay;
+		try {
+			skipReplayHeader(header);
+		}
+		catch(...) {
+			return ReplayState::notAReplay;
+		}
+		if(hasFailed(header)) {
+			return ReplayState::notAReplay;
+		}
+		return getFinalTimeCode(replay).has_value() ? ReplayState::valid : ReplayState::needsFix;
+	}
+
+	//Tell the same state as getReplayState by reading only the first and last bytes of a replay, without parsing its chunks.
+	//head starts at the beginning of replay, and tail ends at the end of replay.
+	//Returns std::nullopt if the header or the footer is longer than head or tail, then getReplayState should be used instead.
+	template<typename HeadRange, typename TailRange>
+	std::optional<ReplayState> probeReplay(HeadRange&& head, TailRange&& tail, std::uint64_t replaySize) {
+		using namespace Internal;
+		static_assert(std::decay_t<TailRange>::isAtLeastForwardIterator, "footer length is stored at the end of replay");
+		using Difference = typename std::iterator_traits<decltype(tail.current)>::difference_type;
+
+		auto magic = head;
+		try {
+			readAndCheckMagic(magic, replayHeaderMagic);
+		}
+		catch(...) {
+			return ReplayState::notAReplay;
+		}
+		if(hasFailed(magic)) {
+			return ReplayState::notAReplay;
+		}
+		auto header = head;
+		auto hasHeader = true;
+		try {
+			skipReplayHeader(header);
+			hasHeader = not hasFailed(header);
+		}
+		catch(...) {
+			hasHeader = false;
+		}
+		if(not hasHeader) {
+			//the header may just be longer than head
+			auto headSize = static_cast<std::uint64_t>(std::distance(head.current, head.end));
+			return headSize < replaySize ? std::nullopt : std::optional{ReplayState::notAReplay};
+		}
+
+		auto tailSize = static_cast<std::uint64_t>(std::distance(tail.current, tail.end));
+		if(tailSize < replaySize and tailSize >= sizeof(std::uint32_t)) {
+			auto footerLengthRange = std::decay_t<TailRange>{std::next(tail.current, static_cast<Difference>(tailSize - sizeof(std::uint32_t))), tail.end};
+			auto terminatorAndFooterLength = std::uint64_t{copyBytes<std::uint32_t>(footerLengthRange)} + terminator.size();
+			if(terminatorAndFooterLength > replaySize or terminatorAndFooterLength > replayMaxFooterSize) {
+				return ReplayState::needsFix; //the last bytes aren't a footer length, reading more won't help
+			}
+			if(terminatorAndFooterLength > tailSize) {
+				return std::nullopt;
+			}
+		}
+		return getFinalTimeCode(tail).has_value() ? ReplayState::valid : ReplayState::needsFix;
+	}
+}
@@ -1,6 +1,15 @@
 #pragma once
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
 #include <vector>
+#include <unordered_map>
+#include <optional>
 #include <string>
 #include <cstdint>
 #include <cstddef>
@@ -8,6 +17,8 @@
 #include <Shlobj.h>
 #include <Shlwapi.h>
 #include "Input.hpp"
+#include "ReplayParser.hpp"
+#include "Parallel.hpp"
 #include "Common.hpp"
 
 //Common.hpp
@@ -15,25 +26,23 @@ template<typename T>
 void readFile(HANDLE file, std::vector<T>& buffer, std::size_t count);
 template<typename T>
 std::vector<T> readFile(HANDLE file, std::size_t count);
+template<typename T>
+std::vector<T> readEntireFile(HANDLE file);
+template<typename T>
+void writeEntireFile(HANDLE file, const std::vector<T>& buffer);
 template<typename InputIterator1, typename InputIterator2>
 bool insensitiveEqual(InputIterator1 begin1, InputIterator1 end1, InputIterator2 begin2, InputIterator2 end2);
 
 namespace ReplaysAndMods {
 
-	struct ReplayDetails {
-		std::wstring fullPath;
-		std::wstring replayName;
-		std::optional<std::uint32_t> finalTimeCode;
-		std::wstring modName;
-		std::wstring modVersion;
-		std::pair<std::uint32_t, std::uint32_t> gameVersion;
-		std::uint32_t timeStamp;
-		std::wstring title;
-		std::wstring map;
-		std::vector<std::wstring> players;
-		std::wstring description;
-		bool hasCommentator;
+	//Replay index entries are keyed by replay file name,
+	//and are only valid when both file size and last write time are unchanged
+	struct ReplayIndexEntry {
+		std::uint64_t fileSize;
+		std::uint64_t lastWriteTime;
+		std::optional<ReplayDetails> details; //std::nullopt if replay cannot be parsed
 	};
+	using ReplayIndex = std::unordered_map<std::wstring, ReplayIndexEntry>;
 
 	struct ModDetails {
 		std::wstring fullPath;
@@ -42,14 +51,16 @@ namespace ReplaysAndMods {
 	};
 
 
-	template<typename Range>
-	ReplayDetails parseReplayHeader(Range&& replay);
-	template<typename Range>
-	std::vector<char> fixReplay(Range&& replay);
-	template<typename Range>
-	std::optional<std::uint32_t> getFinalTimeCodeFromLastBytes(Range&& terminatorAndFooter);
 	inline ReplayDetails getReplayDetails(const std::wstring& replayFullPath);
-	inline std::vector<ReplayDetails> getAllReplayDetails();
+	inline std::vector<ReplayDetails> getAllReplayDetails(std::size_t threadCount = Parallel::defaultThreadCount());
+	template<typename BatchHandler>
+	bool loadAllReplayDetails(BatchHandler onBatch, const std::atomic<bool>& cancelled, std::size_t threadCount = Parallel::defaultThreadCount());
+	template<typename Range>
+	ReplayIndex readReplayIndex(Range&& index);
+	inline std::vector<char> writeReplayIndex(const ReplayIndex& index);
+	inline ReplayIndex loadReplayIndex(const std::wstring& indexFileName);
+	inline void saveReplayIndex(const std::wstring& indexFileName, const ReplayIndex& index);
+	inline std::wstring getReplayIndexFileName();
 	inline std::vector<ModDetails> getModSkudefs();
 	inline std::wstring concatenateWithReplayFolder(std::wstring_view replay);
 	inline std::wstring concatenateWithModRootFolder(std::wstring_view mod);
@@ -57,16 +68,14 @@ namespace ReplaysAndMods {
 
 	inline const auto replayExtension = std::wstring {L".ra3replay"};
 	inline const auto skudefExtension = std::wstring {L".skudef"};
-	inline constexpr auto replayHeaderMagic = std::string_view {"RA3 REPLAY HEADER"};
+	inline const auto replayIndexExtension = std::wstring {L".RA3BarLauncherIndex"};
 	namespace Internal {
 		using namespace Windows;
 		using namespace Input;
 		using namespace std::string_view_literals;
 
-		inline constexpr auto cncMagic = std::string_view {"CNC3RPL\0"sv};
-		inline constexpr auto terminator = std::string_view {"\xFF\xFF\xFF\x7F"sv};
-		inline constexpr auto footerMagic = std::string_view {"RA3 REPLAY FOOTER"sv};
-		inline constexpr auto prePlainTextPadding = 31;
+		inline constexpr auto replayIndexMagic = std::string_view {"RA3BAR REPLAY INDEX"sv};
+		inline constexpr auto replayIndexVersion = std::uint32_t{1};
 
 		inline const std::wstring wildcardAny = L"*";
 
@@ -101,15 +110,66 @@ namespace ReplaysAndMods {
 			return ra3UserPathName;
 		}
 
+		/*
+			Replay index file format, all integers are little endian
+
+			struct ReplayIndex {
+			    char[19];                  //string "RA3BAR REPLAY INDEX"
+			    uint32_t;                  //version number
+			    uint32_t;                  //entry count
+			    Entry[entry count];
+			}
+
+			struct Entry {
+			    String;                    //replay file name
+			    uint64_t;                  //file size
+			    uint64_t;                  //last write time
+			    uint8_t;                   //1 if replay has been parsed successfully, then followed by Details
+			}
+
+			struct Details {
+			    String modName; String modVersion;
+			    uint32_t; uint32_t;        //game version
+			    uint32_t;                  //time stamp
+			    String title; String map;
+			    uint32_t;                  //number of players
+			    String[number of players];
+			    String description;
+			    uint8_t;                   //has commentator
+			    uint8_t;                   //1 if final time code is available, then followed by an uint32_t
+			}
+
+			struct String {
+			    uint32_t;                  //length
+			    char16_t[length];          //UTF-16 LE
+			}
+		*/
+
+		template<typename T>
+		void appendBytes(std::vector<char>& buffer, const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			auto begin = reinterpret_cast<const char*>(&value);
+			buffer.insert(std::end(buffer), begin, begin + sizeof(value));
+		}
+
+		inline void appendIndexString(std::vector<char>& buffer, std::wstring_view string) {
+			appendBytes(buffer, static_cast<std::uint32_t>(string.size()));
+			for(auto character : string) {
+				appendBytes(buffer, static_cast<std::uint16_t>(character));
+			}
+		}
+
 		template<typename InputIterator>
-		std::wstring readNullTerminatedWideString(Range<InputIterator>& input) {
-			auto result = std::wstring {};
-			do {
-				result += copyBytes<wchar_t>(input);
+		std::wstring readIndexString(Range<InputIterator>& input) {
+			auto length = copyBytes<std::uint32_t>(input);
+			if(static_cast<std::uint64_t>(std::distance(input.current, input.end)) < length * std::uint64_t{sizeof(std::uint16_t)}) {
+				throw RangeException("Index string is longer than remaining data");
 			}
-			while(result.back() != L'\0');
-			result.pop_back();
-			return result;
+			auto string = std::wstring{length, {}, std::wstring::allocator_type{}};
+			for(auto& character : string) {
+				character = static_cast<wchar_t>(copyBytes<std::uint16_t>(input));
+			}
+			return string;
 		}
 	}
 
@@ -131,255 +191,294 @@ namespace ReplaysAndMods {
 		return concatenatePath(getRA3UserFolder(L"Mods"), mod);
 	}
 
-	template<typename Range>
-	ReplayDetails parseReplayHeader(Range&& replay) {
+	ReplayDetails getReplayDetails(const std::wstring& replayFullPath) {
 		using namespace Internal;
+		auto file = createFile(replayFullPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING);
+		auto mappedFile = mapFile(file.get());
+		auto replay = ContiguousReader{mappedFile.begin(), mappedFile.end()};
+		auto replayDetails = parseReplayHeader(replay);
+		if(hasFailed(replay)) {
+			throw std::invalid_argument("Failed to parse replay header");
+		}
+		replayDetails.fullPath = replayFullPath;
+		replayDetails.finalTimeCode = getFinalTimeCode(ContiguousReader{mappedFile.begin(), mappedFile.end()});
 
-		readAndCheckMagic(replay, replayHeaderMagic);
-
-		auto hNumber = std::to_integer<unsigned>(copyBytes<std::byte>(replay));
-
-		auto majorVersion = copyBytes<std::uint32_t>(replay);
-		auto minorVersion = copyBytes<std::uint32_t>(replay);
-		auto gameVersion = std::pair{majorVersion, minorVersion};
-
-		ignore<std::uint32_t>(replay); //build major
-		ignore<std::uint32_t>(replay); //build minor
-		ignore<std::byte>(replay);  //commentary track flag?
-		ignore<std::byte>(replay);  //zero
-
-		auto title = readNullTerminatedWideString(replay);
-		auto description = readNullTerminatedWideString(replay);
-		auto mapName = readNullTerminatedWideString(replay);
-		auto mapID = readNullTerminatedWideString(replay);
-
-		auto numberOfPlayers = std::to_integer<std::size_t>(copyBytes<std::byte>(replay));
+		return replayDetails;
+	}
 
-		auto playerNames = std::vector<std::wstring> {numberOfPlayers + 1, {}, std::vector<std::wstring>::allocator_type{}};
-		for(auto& playerName : playerNames) {
-			ignore<std::uint32_t>(replay); //skip player id
-			playerName = readNullTerminatedWideString(replay);
-			if(hNumber == 0x05u) {
-				ignore<std::byte>(replay); //skip team number
+	//Replays which are not found in the index are parsed with threadCount threads.
+	//If threadCount <= 1, they will be parsed sequentially.
+	//Replays are returned in directory order.
+	std::vector<ReplayDetails> getAllReplayDetails(std::size_t threadCount) {
+		auto replaysInDirectoryOrder = std::vector<std::optional<ReplayDetails>> {};
+		auto neverCancelled = std::atomic<bool>{false};
+		loadAllReplayDetails([&replaysInDirectoryOrder](std::vector<ReplayDetails>&& batch, const std::vector<std::size_t>& positions, std::size_t, std::size_t total) {
+			replaysInDirectoryOrder.resize(total);
+			for(auto i = std::size_t{0}; i < batch.size(); ++i) {
+				replaysInDirectoryOrder[positions[i]] = std::move(batch[i]);
 			}
-		}
-		playerNames.pop_back();
-
-		auto offset = copyBytes<std::uint32_t>(replay);
+		}, neverCancelled, threadCount);
 
-		if(copyBytes<std::uint32_t>(replay) != cncMagic.size()) {
-			throw std::invalid_argument("incorrect CNC3RPL magic length");
+		auto replayDetails = std::vector<ReplayDetails> {};
+		for(auto& replay : replaysInDirectoryOrder) {
+			if(replay.has_value()) {
+				replayDetails.emplace_back(std::move(replay.value()));
+			}
 		}
-		readAndCheckMagic(replay, cncMagic);
-
-		constexpr auto modInfoSize = std::size_t{22};
-		auto modInfo = std::string{modInfoSize, {}, std::string::allocator_type{}};
-		copyFixed(replay, modInfo.begin(), modInfo.size());
-		auto modVersion = modInfo.substr(modInfo.find_last_of('\0', modInfo.find_last_not_of('\0')) + 1);
-		modInfo.resize(std::min(modInfo.size(), modInfo.find('\0')));
-		modVersion.resize(std::min(modVersion.size(), modVersion.find('\0')));
-
-		auto timeStamp = copyBytes<std::uint32_t>(replay);
-
-		ignore(replay, prePlainTextPadding);
-		auto plainTextLength = copyBytes<std::uint32_t>(replay);
-		auto plainText = std::string{plainTextLength, {}, std::string::allocator_type{}};
-		copyFixed(replay, plainText.begin(), plainTextLength);
-
-		auto hasCommentator = (plainText.rfind(":Hpost Commentator") != plainText.npos);
-
-		auto afterOffset = cncMagic.size() + modInfo.size() + sizeof(timeStamp)
-		                   + prePlainTextPadding + sizeof(plainTextLength) + plainText.size();
-		ignore(replay, offset - afterOffset);
-
-		using std::move;
-		return {{}, {}, std::nullopt, toWide(modInfo), toWide(modVersion), gameVersion, timeStamp,
-			move(title), move(mapName), move(playerNames), move(description), hasCommentator};
+		return replayDetails;
 	}
 
-	template<typename Range>
-	std::vector<char> fixReplay(Range&& replay) {
+	//Like getAllReplayDetails, but replays are passed to onBatch as soon as they are available:
+	//replays found in the index are passed at once, then the others are passed in small batches while they are being parsed.
+	//onBatch(std::vector<ReplayDetails>&& batch, const std::vector<std::size_t>& positions, std::size_t loaded, std::size_t total)
+	//is called on the calling thread, where positions[i] is the position of batch[i] in directory order,
+	//and loaded and total count every replay file, including those which cannot be parsed.
+	//Replays are parsed by threadCount threads other than the calling thread.
+	//If cancelled becomes true, replays which haven't been started are skipped and false is returned;
+	//they are left out of the index, so they will be parsed next time.
+	template<typename BatchHandler>
+	bool loadAllReplayDetails(BatchHandler onBatch, const std::atomic<bool>& cancelled, std::size_t threadCount) {
 		using namespace Internal;
-		auto enlargeAndGetIterator = [](std::vector<char>& buffer, std::size_t numberOfNewBytesToAdd) {
-			std::size_t oldSize = buffer.size();
-			buffer.resize(oldSize + numberOfNewBytesToAdd);
-			return std::next(std::begin(buffer), oldSize);
-		};
-
-		auto replayData = std::vector<char> {};
-
-		readAndCheckMagic(replay, replayHeaderMagic);
-		std::copy(std::begin(replayHeaderMagic), std::end(replayHeaderMagic),
-		          enlargeAndGetIterator(replayData, replayHeaderMagic.size()));
-
-		auto hNumber = copyBytes<char>(replay);
-		replayData.emplace_back(hNumber);
-
-		auto versionNumbersAndFlagsSize = sizeof(std::uint32_t) * 4 + sizeof(char) * 2;
-		copyFixed(replay, enlargeAndGetIterator(replayData, versionNumbersAndFlagsSize), versionNumbersAndFlagsSize);
-
-		auto copyWideStringAsCharArray = [enlargeAndGetIterator](std::wstring_view string, std::vector<char>& buffer) {
-			auto begin = reinterpret_cast<const char*>(string.data());
-			auto bytesToCopy = string.size() * sizeof(*string.data());
-			return std::copy_n(begin, bytesToCopy, enlargeAndGetIterator(buffer, bytesToCopy));
-		};
-
-		for(auto i = 0; i < 4; ++i) {
-			copyWideStringAsCharArray(readNullTerminatedWideString(replay) + L'\0', replayData);
+		auto replayPath = concatenateWithReplayFolder({});
+		auto allReplays = findAllMatchingFilesWithInformation(concatenatePath(replayPath, wildcardAny + replayExtension));
+		auto indexFileName = getReplayIndexFileName();
+		auto oldIndex = loadReplayIndex(indexFileName);
+		//entries of deleted replays won't be copied into the new index
+		auto indexChanged = (oldIndex.size() != allReplays.size());
+
+		auto entries = std::vector<ReplayIndexEntry> {};
+		auto isLoaded = std::vector<bool> {};
+		auto replaysToBeParsed = std::vector<std::size_t> {};
+		for(const auto& [fileName, fileSize, lastWriteTime] : allReplays) {
+			entries.emplace_back(ReplayIndexEntry{fileSize, lastWriteTime, std::nullopt});
+			auto cached = oldIndex.find(fileName);
+			if(cached != oldIndex.end() and cached->second.fileSize == fileSize and cached->second.lastWriteTime == lastWriteTime) {
+				entries.back().details = std::move(cached->second.details);
+				isLoaded.push_back(true);
+			}
+			else {
+				replaysToBeParsed.emplace_back(entries.size() - 1);
+				isLoaded.push_back(false);
+			}
 		}
+		indexChanged = indexChanged or not replaysToBeParsed.empty();
+
+		auto passToHandler = [&](const std::vector<std::size_t>& replays, std::size_t loaded) {
+			auto batch = std::vector<ReplayDetails> {};
+			auto positions = std::vector<std::size_t> {};
+			for(auto replay : replays) {
+				if(entries[replay].details.has_value()) {
+					auto& details = batch.emplace_back(entries[replay].details.value());
+					details.fullPath = concatenatePath(replayPath, allReplays[replay].fileName);
+					details.replayName = allReplays[replay].fileName;
+					positions.push_back(replay);
+				}
+			}
+			onBatch(std::move(batch), positions, loaded, allReplays.size());
+		};
 
-		auto numberOfPlayers = copyBytes<unsigned char>(replay);
-		replayData.emplace_back(static_cast<char>(numberOfPlayers));
-
-		for(auto i = 0; i < numberOfPlayers + 1; ++i) {
-			copyFixed(replay, enlargeAndGetIterator(replayData, sizeof(std::uint32_t)), sizeof(std::uint32_t));
-			copyWideStringAsCharArray(readNullTerminatedWideString(replay) + L'\0', replayData);
-			if(hNumber == 0x05) {
-				replayData.emplace_back(copyBytes<char>(replay));
+		auto cachedReplays = std::vector<std::size_t> {};
+		for(auto i = std::size_t{0}; i < allReplays.size(); ++i) {
+			if(isLoaded[i]) {
+				cachedReplays.push_back(i);
 			}
 		}
+		auto loadedCount = cachedReplays.size();
+		passToHandler(cachedReplays, loadedCount);
+
+		//All replays are parsed by one forEachIndex, running on its own thread;
+		//the calling thread takes parsed replays from finished and passes them to onBatch.
+		constexpr auto batchSize = std::size_t{64};
+		constexpr auto maximumBatchDelay = std::chrono::milliseconds{100};
+		auto stopping = std::atomic<bool>{false}; //onBatch has thrown
+		auto mutex = std::mutex{};
+		auto finishedChanged = std::condition_variable{};
+		auto finished = std::vector<std::size_t> {};
+		auto parsingDone = false;
+		auto parsingError = std::exception_ptr{};
+		auto parser = std::thread{[&] {
+			try {
+				Parallel::forEachIndex(replaysToBeParsed.size(), threadCount, [&](std::size_t job) {
+					if(cancelled or stopping) {
+						return;
+					}
+					auto replay = replaysToBeParsed[job];
+					try {
+						entries[replay].details = getReplayDetails(concatenatePath(replayPath, allReplays[replay].fileName));
+					}
+					catch(...) { /* simply skip unparsable replays */ }
+					auto lock = std::lock_guard{mutex};
+					finished.push_back(replay);
+					if(finished.size() >= batchSize) {
+						finishedChanged.notify_one();
+					}
+				});
+			}
+			catch(...) {
+				parsingError = std::current_exception();
+			}
+			auto lock = std::lock_guard{mutex};
+			parsingDone = true;
+			finishedChanged.notify_one();
+		}};
 
-		auto offset = copyBytes<std::uint32_t>(replay);
-		std::copy_n(reinterpret_cast<const char*>(&offset), sizeof(offset),
-		            enlargeAndGetIterator(replayData, sizeof(offset)));
-
-		copyFixed(replay, enlargeAndGetIterator(replayData, sizeof(std::uint32_t)), sizeof(std::uint32_t));
-		readAndCheckMagic(replay, cncMagic);
-		std::copy(std::begin(cncMagic), std::end(cncMagic), enlargeAndGetIterator(replayData, cncMagic.size()));
-
-		copyFixed(replay, enlargeAndGetIterator(replayData, offset - cncMagic.size()), offset - cncMagic.size());
-
-		auto lastTimeCode = std::array<char, sizeof(uint32_t)> {};
 		try {
-
-			while(true) {
-				auto chunk = std::vector<char> {};
-
-				auto chunkTimeCode = decltype(lastTimeCode) {};
-				copyFixed(replay, std::begin(chunkTimeCode), chunkTimeCode.size());
-				if(std::equal(std::begin(chunkTimeCode), std::end(chunkTimeCode),
-				              std::begin(terminator), std::end(terminator))) {
-					break;
+			auto done = false;
+			while(not done) {
+				auto replays = std::vector<std::size_t> {};
+				{
+					auto lock = std::unique_lock{mutex};
+					finishedChanged.wait_for(lock, maximumBatchDelay, [&] { return parsingDone or finished.size() >= batchSize; });
+					done = parsingDone;
+					replays.swap(finished);
 				}
+				if(replays.empty()) {
+					continue;
+				}
+				for(auto replay : replays) {
+					isLoaded[replay] = true;
+				}
+				loadedCount += replays.size();
+				passToHandler(replays, loadedCount);
+			}
+		}
+		catch(...) {
+			stopping = true;
+			parser.join();
+			throw;
+		}
+		parser.join();
+		if(parsingError) {
+			std::rethrow_exception(parsingError);
+		}
 
-				std::copy(std::begin(chunkTimeCode), std::end(chunkTimeCode),
-				          enlargeAndGetIterator(chunk, chunkTimeCode.size()));
+		auto newIndex = ReplayIndex{};
+		for(auto i = std::size_t{0}; i < allReplays.size(); ++i) {
+			if(isLoaded[i]) {
+				newIndex.emplace(std::move(allReplays[i].fileName), std::move(entries[i]));
+			}
+		}
 
-				chunk.emplace_back(copyBytes<char>(replay)); //chunk type
+		if(indexChanged) {
+			saveReplayIndex(indexFileName, newIndex);
+		}
+		return loadedCount == allReplays.size();
+	}
 
-				auto chunkSize = copyBytes<std::uint32_t>(replay);
-				std::copy_n(reinterpret_cast<const char*>(&chunkSize), sizeof(chunkSize),
-				            enlargeAndGetIterator(chunk, sizeof(chunkSize)));
-				copyFixed(replay, enlargeAndGetIterator(chunk, chunkSize), chunkSize);
+	template<typename Range>
+	ReplayIndex readReplayIndex(Range&& input) {
+		using namespace Internal;
 
-				constexpr auto zeroes = std::string_view{"\0\0\0\0"sv};
-				readAndCheckMagic(replay, zeroes);
-				std::copy(std::begin(zeroes), std::end(zeroes), enlargeAndGetIterator(chunk, zeroes.size()));
+		readAndCheckMagic(input, replayIndexMagic);
+		if(copyBytes<std::uint32_t>(input) != replayIndexVersion) {
+			throw std::invalid_argument("Unsupported replay index version");
+		}
 
-				lastTimeCode = chunkTimeCode;
-				std::copy(std::begin(chunk), std::end(chunk), enlargeAndGetIterator(replayData, chunk.size()));
+		auto index = ReplayIndex{};
+		auto entryCount = copyBytes<std::uint32_t>(input);
+		for(auto i = std::uint32_t{0}; i < entryCount; ++i) {
+			auto fileName = readIndexString(input);
+			auto entry = ReplayIndexEntry{};
+			entry.fileSize = copyBytes<std::uint64_t>(input);
+			entry.lastWriteTime = copyBytes<std::uint64_t>(input);
+
+			if(copyBytes<std::uint8_t>(input) != 0) {
+				auto details = ReplayDetails{};
+				details.modName = readIndexString(input);
+				details.modVersion = readIndexString(input);
+				details.gameVersion.first = copyBytes<std::uint32_t>(input);
+				details.gameVersion.second = copyBytes<std::uint32_t>(input);
+				details.timeStamp = copyBytes<std::uint32_t>(input);
+				details.title = readIndexString(input);
+				details.map = readIndexString(input);
+				auto numberOfPlayers = copyBytes<std::uint32_t>(input);
+				for(auto j = std::uint32_t{0}; j < numberOfPlayers; ++j) {
+					details.players.emplace_back(readIndexString(input));
+				}
+				details.description = readIndexString(input);
+				details.hasCommentator = (copyBytes<std::uint8_t>(input) != 0);
+				if(copyBytes<std::uint8_t>(input) != 0) {
+					details.finalTimeCode = copyBytes<std::uint32_t>(input);
+				}
+				entry.details = std::move(details);
 			}
 
-			auto footer = std::vector<char> {};
-
-			std::copy(std::begin(terminator), std::end(terminator), enlargeAndGetIterator(footer, terminator.size()));
-			std::copy(replay.current, replay.end, std::back_inserter(footer));
-
-			auto finalTimeCode = getFinalTimeCodeFromLastBytes(Range{std::begin(footer), std::end(footer)}).value();
-			std::copy_n(reinterpret_cast<const char*>(&finalTimeCode), lastTimeCode.size(), std::begin(lastTimeCode));
-
-			std::copy(std::begin(footer), std::end(footer), enlargeAndGetIterator(replayData, footer.size()));
+			index.emplace(std::move(fileName), std::move(entry));
 		}
-		catch(...) {
-			auto myFooter = std::vector<char> {};
-
-			std::copy(std::begin(terminator), std::end(terminator), enlargeAndGetIterator(myFooter, terminator.size()));
-			std::copy(std::begin(footerMagic), std::end(footerMagic), enlargeAndGetIterator(myFooter, footerMagic.size()));
-			std::copy(std::begin(lastTimeCode), std::end(lastTimeCode), enlargeAndGetIterator(myFooter, lastTimeCode.size()));
-			constexpr auto finalData = std::string_view{"\x02\x1A\x00\x00\x00"sv};
-			std::copy(std::begin(finalData), std::end(finalData), enlargeAndGetIterator(myFooter, finalData.size()));
-			auto footerLength = myFooter.size();
-			std::copy_n(reinterpret_cast<const char*>(&footerLength), sizeof(footerLength), enlargeAndGetIterator(myFooter, sizeof(footerLength)));
 
-			std::copy(std::begin(myFooter), std::end(myFooter), enlargeAndGetIterator(replayData, myFooter.size()));
+		if(input.current != input.end) {
+			throw std::invalid_argument("Replay index EOF not reached as expected");
 		}
 
-		return replayData;
+		return index;
 	}
 
-	template<typename Range>
-	std::optional<std::uint32_t> getFinalTimeCodeFromLastBytes(Range&& terminatorAndFooter) {
+	std::vector<char> writeReplayIndex(const ReplayIndex& index) {
 		using namespace Internal;
-		try {
-			readAndCheckMagic(terminatorAndFooter, terminator);
-			readAndCheckMagic(terminatorAndFooter, footerMagic);
-			auto finalTimeCode = copyBytes<std::uint32_t>(terminatorAndFooter);
-
-			auto remainedBytes = std::vector<char> {};
-			std::copy(terminatorAndFooter.current, terminatorAndFooter.end, std::back_inserter(remainedBytes));
-			if(remainedBytes.size() < sizeof(std::uint32_t)) {
-				throw std::out_of_range("remainedBytes.size() < sizeof(std::uint32_t)");
+		auto buffer = std::vector<char> {std::begin(replayIndexMagic), std::end(replayIndexMagic)};
+		appendBytes(buffer, replayIndexVersion);
+		appendBytes(buffer, static_cast<std::uint32_t>(index.size()));
+		for(const auto& [fileName, entry] : index) {
+			appendIndexString(buffer, fileName);
+			appendBytes(buffer, entry.fileSize);
+			appendBytes(buffer, entry.lastWriteTime);
+			appendBytes(buffer, static_cast<std::uint8_t>(entry.details.has_value()));
+			if(not entry.details.has_value()) {
+				continue;
+			}
+			const auto& details = entry.details.value();
+			appendIndexString(buffer, details.modName);
+			appendIndexString(buffer, details.modVersion);
+			appendBytes(buffer, details.gameVersion.first);
+			appendBytes(buffer, details.gameVersion.second);
+			appendBytes(buffer, details.timeStamp);
+			appendIndexString(buffer, details.title);
+			appendIndexString(buffer, details.map);
+			appendBytes(buffer, static_cast<std::uint32_t>(details.players.size()));
+			for(const auto& player : details.players) {
+				appendIndexString(buffer, player);
 			}
-			auto footerLengthRange = Range{std::end(remainedBytes) - sizeof(std::uint32_t), std::end(remainedBytes)};
-			auto footerLength = copyBytes<std::uint32_t>(footerLengthRange);
-			if((footerLength - footerMagic.size() - sizeof(finalTimeCode)) != remainedBytes.size()) {
-				throw std::invalid_argument("Incorrect footer length");
+			appendIndexString(buffer, details.description);
+			appendBytes(buffer, static_cast<std::uint8_t>(details.hasCommentator));
+			appendBytes(buffer, static_cast<std::uint8_t>(details.finalTimeCode.has_value()));
+			if(details.finalTimeCode.has_value()) {
+				appendBytes(buffer, details.finalTimeCode.value());
 			}
-			return finalTimeCode;
 		}
-		catch(...) { }
-		return std::nullopt;
+		return buffer;
 	}
 
-	ReplayDetails getReplayDetails(const std::wstring& replayFullPath) {
+	ReplayIndex loadReplayIndex(const std::wstring& indexFileName) {
 		using namespace Internal;
-		auto file = createFile(replayFullPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING);
-		auto buffer = std::vector<char> {};
-		auto replayDetails = ReplayDetails{};
-		while(true) {
-			auto fileSize = getFileSize(file.get());
-			readFile(file.get(), buffer, std::clamp<std::size_t>(buffer.size() * 2, 1024, fileSize - buffer.size()));
-			try {
-				replayDetails = parseReplayHeader(Range{std::begin(buffer), std::end(buffer)});
-				break;
-			}
-			catch(const RangeException&) {
-				if(buffer.size() >= fileSize) {
-					throw;
-				}
-			}
-		}
-		replayDetails.fullPath = std::move(replayFullPath);
-
-		auto footerLength = std::uint32_t{};
-		setFilePointer(file.get(), -static_cast<LONGLONG>(sizeof(footerLength)), FILE_END);
-		auto lengthBuffer = readFile<char>(file.get(), sizeof(std::uint32_t));
-		std::copy(std::begin(lengthBuffer), std::end(lengthBuffer), reinterpret_cast<char*>(&footerLength));
-
 		try {
-			auto terminatorAndFooterLength = footerLength + sizeof(std::uint32_t);
-			setFilePointer(file.get(), -static_cast<LONGLONG>(terminatorAndFooterLength), FILE_END);
-			auto lastBytes = readFile<char>(file.get(), terminatorAndFooterLength);
-			replayDetails.finalTimeCode = getFinalTimeCodeFromLastBytes(Range{std::begin(lastBytes), std::end(lastBytes)});
+			auto content = readEntireFile<char>(createFile(indexFileName, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING).get());
+			return readReplayIndex(Range{std::begin(content), std::end(content)});
 		}
-		catch(...) { }
-
-		return replayDetails;
+		catch(...) { } //index does not exist or is corrupted, it will be rebuilt
+		return {};
 	}
 
-	std::vector<ReplayDetails> getAllReplayDetails() {
+	void saveReplayIndex(const std::wstring& indexFileName, const ReplayIndex& index) {
 		using namespace Internal;
-		auto replayPath = concatenateWithReplayFolder({});
-		auto allReplays = findAllMatchingFiles(concatenatePath(replayPath, wildcardAny + replayExtension));
-		auto replayDetails = std::vector<ReplayDetails> {};
-		for(auto& fileName : allReplays) {
-			try {
-				replayDetails.emplace_back(getReplayDetails(concatenatePath(replayPath, fileName)));
-				replayDetails.back().replayName = std::move(fileName);
+		try {
+			auto temporaryFileName = indexFileName + L".tmp";
+			{
+				auto file = createFile(temporaryFileName, GENERIC_WRITE, 0, CREATE_ALWAYS);
+				writeEntireFile(file.get(), writeReplayIndex(index));
 			}
-			catch(...) { /* simply skip unparsable replays */ }
+			MoveFileExW(temporaryFileName.c_str(), indexFileName.c_str(), MOVEFILE_REPLACE_EXISTING)
+			        >> checkWin32Result("MoveFileExW", errorValue, false);
 		}
-		return replayDetails;
+		catch(...) { } //index is only a cache, failing to save it is not fatal
+	}
+
+	std::wstring getReplayIndexFileName() {
+		//the index file is placed next to the replay folder, so it won't be listed as a replay
+		auto replayFolder = concatenateWithReplayFolder({});
+		while(not replayFolder.empty() and PathGetCharType(replayFolder.back()) == GCT_SEPARATOR) {
+			replayFolder.pop_back();
+		}
+		return replayFolder + replayIndexExtension;
 	}
 
 	std::vector<ModDetails> getModSkudefs() {
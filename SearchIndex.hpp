@@ -0,0 +1,169 @@
+//Case-insensitive instant search over a growing list of documents
+//(such as the replays of the Game Browser), backed by a trigram index.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <locale>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//Every document is made of several fields, stored once as a case-folded text.
+//A query matches a document if every word of query is a part of one of its fields.
+//Documents can be added at any time, they are numbered in the order they are added.
+class SearchIndex {
+	public:
+		std::size_t size() const noexcept { return this->offsets.size() - 1; }
+
+		void clear() {
+			this->texts.clear();
+			this->offsets.assign(1, 0);
+			this->postings.clear();
+			this->lastQuery.clear();
+			this->lastResult.clear();
+			this->lastSize = 0;
+		}
+
+		//Add a document made of fields, a range of strings, and return its number
+		template<typename Fields>
+		std::size_t add(const Fields& fields) {
+			auto document = this->size();
+			auto begin = this->texts.size();
+			for(const auto& field : fields) {
+				appendFolded(this->texts, field);
+				//no query contains a separator, so trigrams spanning two fields never match
+				this->texts.push_back(separator);
+			}
+			this->offsets.push_back(this->texts.size());
+
+			for(auto i = begin; i + trigramLength <= this->texts.size(); ++i) {
+				auto& list = this->postings[getTrigram(this->texts.data() + i)];
+				if(list.empty() or list.back() != document) {
+					list.push_back(static_cast<std::uint32_t>(document));
+				}
+			}
+			return document;
+		}
+
+		bool matches(std::size_t document, std::wstring_view query) const {
+			auto folded = fold(query);
+			auto words = splitWords(folded);
+			return this->matchesWords(document, words);
+		}
+
+		//Numbers of documents matching query, in ascending order.
+		//While query is being typed, every query only adds characters to the previous one,
+		//so only the previous result (and documents added since then) need to be searched again.
+		std::vector<std::size_t> search(std::wstring_view query) {
+			auto folded = fold(query);
+			auto words = splitWords(folded);
+			auto narrowing = not this->lastQuery.empty() and folded.compare(0, this->lastQuery.size(), this->lastQuery) == 0;
+
+			const auto* candidates = static_cast<const std::vector<std::uint32_t>*>(nullptr);
+			auto noMatch = false;
+			for(const auto& word : words) {
+				for(auto i = std::size_t{0}; i + trigramLength <= word.size(); ++i) {
+					auto list = this->postings.find(getTrigram(word.data() + i));
+					if(list == this->postings.end()) {
+						noMatch = true;
+						break;
+					}
+					if(candidates == nullptr or list->second.size() < candidates->size()) {
+						candidates = &list->second;
+					}
+				}
+			}
+
+			auto result = std::vector<std::size_t>{};
+			auto keepMatches = [this, &words, &result](auto begin, auto end) {
+				for(auto document = begin; document != end; ++document) {
+					if(this->matchesWords(*document, words)) {
+						result.push_back(*document);
+					}
+				}
+			};
+			auto keepMatchesAfter = [this, &words, &result](std::size_t first) {
+				for(auto document = first; document < this->size(); ++document) {
+					if(this->matchesWords(document, words)) {
+						result.push_back(document);
+					}
+				}
+			};
+			if(noMatch) {
+				//a trigram of query isn't in any document
+			}
+			else if(narrowing and (candidates == nullptr or this->lastResult.size() < candidates->size())) {
+				keepMatches(this->lastResult.begin(), this->lastResult.end());
+				keepMatchesAfter(this->lastSize);
+			}
+			else if(candidates != nullptr) {
+				keepMatches(candidates->begin(), candidates->end());
+			}
+			else {
+				keepMatchesAfter(0);
+			}
+
+			this->lastQuery = std::move(folded);
+			this->lastResult = result;
+			this->lastSize = this->size();
+			return result;
+		}
+
+	private:
+		static constexpr auto separator = L'\n';
+		static constexpr auto trigramLength = std::size_t{3};
+
+		static std::uint64_t getTrigram(const wchar_t* characters) noexcept {
+			auto trigram = std::uint64_t{0};
+			for(auto i = std::size_t{0}; i < trigramLength; ++i) {
+				trigram = (trigram << 21) | (static_cast<std::uint64_t>(characters[i]) & 0x1FFFFF);
+			}
+			return trigram;
+		}
+
+		template<typename String>
+		static void appendFolded(std::wstring& output, const String& string) {
+			for(auto character : string) {
+				output.push_back(std::tolower(static_cast<wchar_t>(character), std::locale::classic()));
+			}
+		}
+
+		static std::wstring fold(std::wstring_view string) {
+			auto folded = std::wstring{};
+			folded.reserve(string.size());
+			appendFolded(folded, string);
+			return folded;
+		}
+
+		static std::vector<std::wstring_view> splitWords(std::wstring_view query) {
+			auto words = std::vector<std::wstring_view>{};
+			auto isSpace = [](wchar_t character) { return std::isspace(character, std::locale::classic()); };
+			auto current = query.begin();
+			while(current != query.end()) {
+				auto wordBegin = std::find_if_not(current, query.end(), isSpace);
+				auto wordEnd = std::find_if(wordBegin, query.end(), isSpace);
+				if(wordBegin != wordEnd) {
+					words.emplace_back(&*wordBegin, static_cast<std::size_t>(wordEnd - wordBegin));
+				}
+				current = wordEnd;
+			}
+			return words;
+		}
+
+		bool matchesWords(std::size_t document, const std::vector<std::wstring_view>& words) const {
+			auto text = std::wstring_view{this->texts}.substr(this->offsets[document], this->offsets[document + 1] - this->offsets[document]);
+			return std::all_of(words.begin(), words.end(), [text](std::wstring_view word) {
+				return text.find(word) != text.npos;
+			});
+		}
+
+		std::wstring texts;                                                     //case-folded fields of every document
+		std::vector<std::size_t> offsets = {0};                                 //texts of document n are [offsets[n], offsets[n + 1])
+		std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> postings; //documents containing every trigram
+		std::wstring lastQuery;
+		std::vector<std::size_t> lastResult;
+		std::size_t lastSize = 0;
+};
@@ -6,9 +6,15 @@
 #include <array>
 #include <vector>
 #include <string>
-#include <map>
 #include <optional>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <cstdio>
+#include <cwchar>
 #include <locale>
 #include <Windows.h>
 #include <CommCtrl.h>
@@ -16,6 +22,9 @@
 #include "UserInterface.hpp"
 #include "WindowsWrapper.hpp"
 #include "ReplaysAndMods.hpp"
+#include "ListOrder.hpp"
+#include "SearchIndex.hpp"
+#include "BuiltinStrings.hpp"
 #include "resource.h"
 
 using namespace Windows;
@@ -72,6 +81,8 @@ enum ID  {
 	fixReplaySucceeded,
 	fixReplayFailed,
 	replayFolder,
+	replayLoadingProgress,
+	replayFilter,
 	//launcher / game browser launching game (replay)
 	replayCantBePlayed,
 	replayCantBeParsedText,
@@ -92,70 +103,82 @@ enum ID  {
 	gameVersionNotFound,
 	noModsFound,
 	multipleModsFound,
+
+	numberOfIDs,
 };
 
-const std::wstring& getText(const LanguageData& data, ID id) {
-	static auto labels = std::map<ID, std::wstring> {
-		{errorMessage, L"RA3BarLauncher:ErrorMessage"},
-		{captionString, L"Launcher:Caption"},
-		{splashScreen, L"RA3BarLauncher:ClickSplashScreen"},
-		{playGame, L"Launcher:Play"},
-		{checkForUpdates, L"Launcher:CheckForUpdates"},
-		{setLanguage, L"Launcher:SelectLanguage"},
-		{gameBrowser, L"Launcher:ReplayBrowser"},
-		{readMe, L"Launcher:Readme"},
-		{visitEAWebsite, L"Launcher:Website"},
-		{technicalSupport, L"Launcher:TechnicalSupport"},
-		{deauthorize, L"Launcher:DeAuthorize"},
-		{quit, L"Launcher:Quit"},
-		{about, L"RA3BarLauncher:About"},
-		{commandLine, L"RA3BarLauncher:CommandLine"},
-		{setLanguageDescription, L"Launcher:SelectLanguageText"},
-		{setLanguageOK, L"Dialog:OK"},
-		{setLanguageCancel, L"Dialog:Cancel"},
-		{gameBrowserLaunchGame, L"REPLAYBROWSER:WATCHREPLAY"},
-		{gameBrowserCancel, L"Dialog:Cancel"},
-		{mods, L"LAUNCHER:MODTAB"},
-		{modListModName, L"MODBROWSER:NAMECOLUMN"},
-		{modListModVersion, L"MODBROWSER:VERSIONCOLUMN"},
-		{modFolder, L"RA3BarLauncher:OpenModFolder"},
-		{replays, L"LAUNCHER:REPLAYTAB"},
-		{replayListReplayName, L"REPLAYBROWSER:NAMECOLUMN"},
-		{replayListModName, L"REPLAYBROWSER:MODCOLUMN"},
-		{replayListGameVersion, L"REPLAYBROWSER:VERSIONCOLUMN"},
-		{replayListDate, L"REPLAYBROWSER:DATECOLUMN"},
-		{replayMatchInformation, L"REPLAYBROWSER:MATCHINFO"},
-		{replayMap, L"REPLAYBROWSER:MAP"},
-		{replayNumberOfPlayers, L"REPLAYBROWSER:NUMPLAYERS"},
-		{replayDescription, L"REPLAYBROWSER:DESCRIPTION"},
-		{fixReplay, L"RA3BarLauncher:FixReplay"},
-		{fixReplayWarning, L"RA3BarLauncher:FixReplayWillReplaceOriginal"},
-		{fixReplaySucceeded, L"RA3BarLauncher:FixReplaySuccess"},
-		{fixReplayFailed, L"RA3BarLauncher:FixReplayFailure"},
-		{replayFolder, L"RA3BarLauncher:OpenReplayFolder"},
-		{webSiteLink, L"Launcher:URL"},
-		{eaSupportURL, L"RA3BarLauncher:EASupportWebsite"},
-		{useOriginalRA3Title, L"RA3BarLauncher:NeedOriginalLauncher"},
-		{useOriginalRA3ToUpdate, L"RA3BarLauncher:UpdateNotSupported"},
-		{useOriginalRA3ToDeauthorize, L"RA3BarLauncher:DeauthorizeNotSupported"},
-		{replayCantBePlayed, L"RA3BarLauncher:ReplayCannotBePlayed"},
-		{replayCantBeParsedText, L"RA3BarLauncher:ReplayCannotBeParsed"},
-		{replayDontHaveCommentator, L"RA3BarLauncher:ReplayDoesNotHaveCommentator"},
-		{replayNeedsToBeFixed, L"RA3BarLauncher:ReplayNeedsToBeFixed"},
-		{replayNeedsToBeFixedText, L"RA3BarLauncher:ReplayNeedsToBeFixedText"},
-		{aboutText, L"RA3BarLauncher:AboutText"},
-		{resourceAuthors, L"RA3BarLauncher:ResourceAuthors"},
-		{gameVersionNotFound, L"Launcher:CantFindVersionN_InstallPatches"},
-		{noModsFound, L"REPLAYBROWSER:MODNOTINSTALLED"},
-		{multipleModsFound, L"RA3BarLauncher:ReplayModAmbiguity"},
-	};
+constexpr std::pair<ID, std::wstring_view> textLabels[] = {
+	{errorMessage, L"RA3BarLauncher:ErrorMessage"},
+	{captionString, L"Launcher:Caption"},
+	{splashScreen, L"RA3BarLauncher:ClickSplashScreen"},
+	{playGame, L"Launcher:Play"},
+	{checkForUpdates, L"Launcher:CheckForUpdates"},
+	{setLanguage, L"Launcher:SelectLanguage"},
+	{gameBrowser, L"Launcher:ReplayBrowser"},
+	{readMe, L"Launcher:Readme"},
+	{visitEAWebsite, L"Launcher:Website"},
+	{technicalSupport, L"Launcher:TechnicalSupport"},
+	{deauthorize, L"Launcher:DeAuthorize"},
+	{quit, L"Launcher:Quit"},
+	{about, L"RA3BarLauncher:About"},
+	{commandLine, L"RA3BarLauncher:CommandLine"},
+	{setLanguageDescription, L"Launcher:SelectLanguageText"},
+	{setLanguageOK, L"Dialog:OK"},
+	{setLanguageCancel, L"Dialog:Cancel"},
+	{gameBrowserLaunchGame, L"REPLAYBROWSER:WATCHREPLAY"},
+	{gameBrowserCancel, L"Dialog:Cancel"},
+	{mods, L"LAUNCHER:MODTAB"},
+	{modListModName, L"MODBROWSER:NAMECOLUMN"},
+	{modListModVersion, L"MODBROWSER:VERSIONCOLUMN"},
+	{modFolder, L"RA3BarLauncher:OpenModFolder"},
+	{replays, L"LAUNCHER:REPLAYTAB"},
+	{replayListReplayName, L"REPLAYBROWSER:NAMECOLUMN"},
+	{replayListModName, L"REPLAYBROWSER:MODCOLUMN"},
+	{replayListGameVersion, L"REPLAYBROWSER:VERSIONCOLUMN"},
+	{replayListDate, L"REPLAYBROWSER:DATECOLUMN"},
+	{replayMatchInformation, L"REPLAYBROWSER:MATCHINFO"},
+	{replayMap, L"REPLAYBROWSER:MAP"},
+	{replayNumberOfPlayers, L"REPLAYBROWSER:NUMPLAYERS"},
+	{replayDescription, L"REPLAYBROWSER:DESCRIPTION"},
+	{fixReplay, L"RA3BarLauncher:FixReplay"},
+	{fixReplayWarning, L"RA3BarLauncher:FixReplayWillReplaceOriginal"},
+	{fixReplaySucceeded, L"RA3BarLauncher:FixReplaySuccess"},
+	{fixReplayFailed, L"RA3BarLauncher:FixReplayFailure"},
+	{replayFolder, L"RA3BarLauncher:OpenReplayFolder"},
+	{replayFilter, L"RA3BarLauncher:FilterReplays"},
+	{webSiteLink, L"Launcher:URL"},
+	{eaSupportURL, L"RA3BarLauncher:EASupportWebsite"},
+	{useOriginalRA3Title, L"RA3BarLauncher:NeedOriginalLauncher"},
+	{useOriginalRA3ToUpdate, L"RA3BarLauncher:UpdateNotSupported"},
+	{useOriginalRA3ToDeauthorize, L"RA3BarLauncher:DeauthorizeNotSupported"},
+	{replayCantBePlayed, L"RA3BarLauncher:ReplayCannotBePlayed"},
+	{replayCantBeParsedText, L"RA3BarLauncher:ReplayCannotBeParsed"},
+	{replayDontHaveCommentator, L"RA3BarLauncher:ReplayDoesNotHaveCommentator"},
+	{replayNeedsToBeFixed, L"RA3BarLauncher:ReplayNeedsToBeFixed"},
+	{replayNeedsToBeFixedText, L"RA3BarLauncher:ReplayNeedsToBeFixedText"},
+	{aboutText, L"RA3BarLauncher:AboutText"},
+	{resourceAuthors, L"RA3BarLauncher:ResourceAuthors"},
+	{gameVersionNotFound, L"Launcher:CantFindVersionN_InstallPatches"},
+	{noModsFound, L"REPLAYBROWSER:MODNOTINSTALLED"},
+	{multipleModsFound, L"RA3BarLauncher:ReplayModAmbiguity"},
+};
 
-	auto loadMyCSF = [](HMODULE module, LPCWSTR resource, LPCWSTR type) {
-		auto data = loadBinaryDataResource<char>(module, resource, type);
-		return loadCSFStrings(std::begin(data), std::end(data));
-	};
-	static auto myEnglish = loadMyCSF(GetModuleHandle(nullptr), MAKEINTRESOURCEW(BUILTIN_ENGLISH), RT_RCDATA);
-	static auto myChinese = loadMyCSF(GetModuleHandle(nullptr), MAKEINTRESOURCEW(BUILTIN_CHINESE), RT_RCDATA);
+//Built-in strings of every ID, copied from the tables compiled into BuiltinStrings.hpp; IDs without a built-in string stay empty
+template<std::size_t size>
+std::array<std::optional<std::wstring>, numberOfIDs> getBuiltinTexts(const BuiltinStrings::BuiltinString (&table)[size]) {
+	auto texts = std::array<std::optional<std::wstring>, numberOfIDs>{};
+	for(const auto& [id, label] : textLabels) {
+		if(auto string = BuiltinStrings::find(table, label); string != nullptr) {
+			texts[id] = std::wstring{string->text};
+		}
+	}
+	return texts;
+}
+
+void resolveTexts(LanguageData& data) {
+	static const auto myEnglish = getBuiltinTexts(BuiltinStrings::english);
+	static const auto myChinese = getBuiltinTexts(BuiltinStrings::chinese);
+	static const auto error = std::wstring{L"<ERROR NO CSFSTRING>"};
 
 	auto currentMyMap = &myEnglish;
 	auto chinese = std::wstring_view{L"chinese"};
@@ -164,17 +187,29 @@ const std::wstring& getText(const LanguageData& data, ID id) {
 		currentMyMap = &myChinese;
 	}
 
-	const auto& label = labels.at(id);
-
-	auto string = data.table.find(label);
-	if(string == data.table.end()) {
-		string = currentMyMap->find(label);
-		if(string == currentMyMap->end()) {
-			static auto error = std::wstring{L"<ERROR NO CSFSTRING>"};
-			return error;
+	//IDs without a label stay nullptr
+	data.texts.assign(numberOfIDs, nullptr);
+	for(const auto& [id, label] : textLabels) {
+		auto string = data.table.find(label);
+		if(string == nullptr and (*currentMyMap)[id].has_value()) {
+			string = &(*currentMyMap)[id].value();
 		}
+		data.texts[id] = (string != nullptr) ? string : &error;
 	}
-	return string->second;
+}
+
+const std::wstring& getText(const LanguageData& data, ID id) {
+	static const auto builtinEnglish = [] {
+		auto builtin = LanguageData{};
+		resolveTexts(builtin);
+		return builtin;
+	}();
+	const auto& texts = data.texts.empty() ? builtinEnglish.texts : data.texts;
+	auto string = texts.at(id);
+	if(string == nullptr) {
+		throw std::out_of_range("getText(): ID doesn't have a label");
+	}
+	return *string;
 }
 
 const std::wstring& getLanguageName(const LanguageData& data, const std::wstring& languageName) {
@@ -186,11 +221,11 @@ const std::wstring& getLanguageName(const LanguageData& data, const std::wstring
 	}
 
 	auto string = data.table.find(languageTag);
-	if(string == data.table.end()) {
+	if(string == nullptr) {
 		static auto error = std::wstring{L"<ERROR LANGUAGE NAME>"};
 		return error;
 	}
-	return string->second;
+	return *string;
 }
 
 void displayErrorMessage(const std::exception& error, const LanguageData& languageData) {
@@ -285,7 +320,7 @@ DWORD colorMultiply (DWORD color, std::uint8_t multiplier) {
 	return result;
 }
 
-LanguageData getNewLanguage(HWND controlCenter, const std::wstring& ra3Path, HICON icon, const LanguageData& languageData);
+LanguageData getNewLanguage(HWND controlCenter, const std::wstring& ra3Path, HICON icon, const LanguageData& languageData, LanguagePreloader& languagePreloader);
 std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstring& ra3Path, HICON icon, const LanguageData& languageData);
 void aboutWindow(HWND parent, HICON icon, const LanguageData& languageData);
 
@@ -529,6 +564,9 @@ std::optional<LaunchOptions> runControlCenter(const std::wstring& ra3Path, const
 	auto handlers = ModalDialogBox::HandlerTable{};
 	auto returnValue = std::optional<LaunchOptions> {};
 
+	//language packs are loaded while the Control Center is open, so changing language won't need to wait for them
+	auto languagePreloader = LanguagePreloader{ra3Path};
+
 	auto setUpBrushes = [&ra3Path, &languageData, customBackground, &backgroundBrushes, &buttonBrushes](HDC deviceContext) {
 		using std::bind;
 		using std::ref;
@@ -682,12 +720,7 @@ std::optional<LaunchOptions> runControlCenter(const std::wstring& ra3Path, const
 	};
 
 	auto getCommandLines = [](HWND controlCenter) {
-		auto commandLineWindow = getControlByID(controlCenter, commandLine);
-		auto length = GetWindowTextLengthW(commandLineWindow);
-		auto windowString = std::wstring{static_cast<std::size_t>(length + 1), L'\0', std::wstring::allocator_type{}};
-		auto realLength = GetWindowTextW(commandLineWindow, windowString.data(), length + 1);
-		windowString.resize(realLength);
-		return windowString;
+		return getWindowText(getControlByID(controlCenter, commandLine));
 	};
 
 	auto endControlCenter = [&returnValue](HWND window, std::optional<LaunchOptions> launchOptions) {
@@ -695,7 +728,7 @@ std::optional<LaunchOptions> runControlCenter(const std::wstring& ra3Path, const
 		EndDialog(window, 0) >> checkWin32Result("EndDialog", errorValue, false);
 	};
 
-	handlers[WM_COMMAND] = [&ra3Path, &languageData, &icon, setUpBrushes, adjustButtonFont, getCommandLines, endControlCenter](HWND window, WPARAM codeAndIdentifier, LPARAM childWindow) {
+	handlers[WM_COMMAND] = [&ra3Path, &languageData, &icon, &languagePreloader, setUpBrushes, adjustButtonFont, getCommandLines, endControlCenter](HWND window, WPARAM codeAndIdentifier, LPARAM childWindow) {
 		auto notificationCode = HIWORD(codeAndIdentifier);
 		auto identifier = LOWORD(codeAndIdentifier);
 		if(notificationCode != BN_CLICKED) {
@@ -711,7 +744,7 @@ std::optional<LaunchOptions> runControlCenter(const std::wstring& ra3Path, const
 				break;
 			}
 			case setLanguage: {
-				languageData = getNewLanguage(window, ra3Path, icon.get(), languageData);
+				languageData = getNewLanguage(window, ra3Path, icon.get(), languageData, languagePreloader);
 				SetWindowTextW(window, getText(languageData, captionString).c_str()) >> checkWin32Result("SetWindowTextW", successValue, true);
 				setUpBrushes(getDeviceContext(window)->context);
 				adjustButtonFont(window);
@@ -818,7 +851,7 @@ std::optional<LaunchOptions> runControlCenter(const std::wstring& ra3Path, const
 	return returnValue;
 }
 
-LanguageData getNewLanguage(HWND controlCenter, const std::wstring& ra3Path, HICON icon, const LanguageData& languageData) {
+LanguageData getNewLanguage(HWND controlCenter, const std::wstring& ra3Path, HICON icon, const LanguageData& languageData, LanguagePreloader& languagePreloader) {
 
 	constexpr auto buttonWidth = 100;
 	constexpr auto buttonHeight = 30;
@@ -848,7 +881,7 @@ LanguageData getNewLanguage(HWND controlCenter, const std::wstring& ra3Path, HIC
 	auto banner480Brush = tryWith(std::bind(createPatternBrush, banner480.get()), nullptr);
 	auto font = getNormalFont();
 
-	auto languages = getAllLanguages(ra3Path);
+	auto languages = languagePreloader.languages();
 	if(auto current = std::find(std::begin(languages), std::end(languages), languageData.languageName);
 	        current != std::end(languages) and current != std::begin(languages)) {
 		std::swap(*current, *std::begin(languages));
@@ -915,14 +948,16 @@ LanguageData getNewLanguage(HWND controlCenter, const std::wstring& ra3Path, HIC
 	};
 
 	auto result = modalDialogBox(handlers, WS_VISIBLE|WS_SYSMENU, 0, controlCenter);
-	return loadLanguageData(ra3Path, languages.at(result));
+	auto newLanguageData = languagePreloader.load(languages.at(result));
+	resolveTexts(newLanguageData);
+	return newLanguageData;
 };
 
 
 template<typename IDWidthList>
 WindowHandle createListView(HWND parent, ID id, const IDWidthList& columns, RECT windowRect, const LanguageData& languageData) {
 	auto listView = createControl(parent, id, WC_LISTVIEWW, {},
-	                              LVS_REPORT|LVS_SHOWSELALWAYS|LVS_SINGLESEL, 0,
+	                              LVS_REPORT|LVS_SHOWSELALWAYS|LVS_SINGLESEL|LVS_OWNERDATA, 0,
 	                              windowRect.left, windowRect.top, rectWidth(windowRect), rectHeight(windowRect));
 	SendMessageW(listView.get(), LVM_SETEXTENDEDLISTVIEWSTYLE, 0, LVS_EX_GRIDLINES | LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
 	auto listViewWidth = rectWidth(getClientRect(listView.get())) - GetSystemMetrics(SM_CXVSCROLL); //minus width of scroll bar
@@ -942,68 +977,219 @@ WindowHandle createListView(HWND parent, ID id, const IDWidthList& columns, RECT
 	return listView;
 }
 
-void replaceListView (HWND listView, std::vector<std::vector<std::wstring>> items) {
-	SendMessageW(listView, LVM_DELETEALLITEMS, 0, 0)
-	        >> checkWin32Result("SendMessageW LVM_DELETEALLITEMS", errorValue, false);
-
-	for(auto index = std::size_t{0}; index < items.size(); ++index) {
-		for(auto subIndex = std::size_t{0}; subIndex < items[index].size(); ++subIndex) {
-			auto listItem = LVITEMW{LVIF_TEXT};
-			listItem.iItem = index;
-			listItem.iSubItem = subIndex;
-			listItem.pszText = items[index][subIndex].data();
-			if(listItem.iSubItem == 0) {
-				SendMessageW(listView, LVM_INSERTITEMW, 0, reinterpret_cast<LPARAM>(&listItem))
-				        >> checkWin32Result("SendMessageW LVM_INSERTITEMW", errorValue, -1);
-			}
-			else {
-				SendMessageW(listView, LVM_SETITEMW, 0, reinterpret_cast<LPARAM>(&listItem))
-				        >> checkWin32Result("SendMessageW LVM_INSERTITEMW", errorValue, false);
-			}
-		}
+//List views are virtual, texts of rows are requested by LVN_GETDISPINFOW only when they are shown,
+//so refreshing a list only needs to set its number of rows
+void refreshListView(HWND listView, std::size_t rowCount) {
+	//clear selection, like when all items were deleted
+	auto itemState = LVITEMW{};
+	itemState.stateMask = LVIS_SELECTED|LVIS_FOCUSED;
+	SendMessageW(listView, LVM_SETITEMSTATE, -1, reinterpret_cast<LPARAM>(&itemState))
+	        >> checkWin32Result("SendMessageW LVM_SETITEMSTATE", errorValue, false);
+	SendMessageW(listView, LVM_SETITEMCOUNT, rowCount, 0)
+	        >> checkWin32Result("SendMessageW LVM_SETITEMCOUNT", errorValue, false);
+	InvalidateRect(listView, nullptr, true) >> checkWin32Result("InvalidateRect", errorValue, false);
+}
+
+//Answer a LVN_GETDISPINFOW request, text is truncated if it doesn't fit into the buffer of list view
+void setDisplayText(LVITEMW& item, std::wstring_view text) {
+	if(not (item.mask bitand LVIF_TEXT) or item.cchTextMax <= 0) {
+		return;
 	}
+	auto length = std::min(text.size(), static_cast<std::size_t>(item.cchTextMax - 1));
+	std::copy_n(text.data(), length, item.pszText);
+	item.pszText[length] = L'\0';
 }
 
-struct ReplaysAndModsData {
+//Formats timestamps of replays as local date and time.
+//Seconds aren't shown, so texts are cached per minute. Dates and times are also cached separately,
+//because many replays are played on the same day, and there are only 1440 different times.
+class TimeStampFormatter {
+	public:
+		const std::wstring& format(std::uint32_t timeStamp) {
+			auto minute = timeStamp / 60;
+			auto cached = this->texts.find(minute);
+			if(cached != this->texts.end()) {
+				return cached->second;
+			}
 
-	std::vector<std::vector<std::wstring>> replayDetailsToStrings() const {
+			auto localTime = toLocalTime(timeStamp);
+			auto dateKey = (static_cast<std::uint32_t>(localTime.wYear) << 9) bitor (localTime.wMonth << 5) bitor localTime.wDay;
+			auto timeKey = static_cast<std::uint32_t>(localTime.wHour) * 60 + localTime.wMinute;
+			const auto& date = getOrFormat(this->dates, dateKey, GetDateFormatW, DATE_LONGDATE, localTime);
+			const auto& time = getOrFormat(this->times, timeKey, GetTimeFormatW, TIME_NOSECONDS, localTime);
+			return this->texts.emplace(minute, date + L' ' + time).first->second;
+		}
 
-		auto allocateFormat = [](auto function, DWORD flags, const SYSTEMTIME& time) {
-			auto size = function(LOCALE_USER_DEFAULT, flags, &time, nullptr, nullptr, 0)
-			            >> checkWin32Result("allocateFormat", errorValue, 0);
-			auto string = std::wstring{static_cast<std::size_t>(size), {}, std::wstring::allocator_type{}};
-			function(LOCALE_USER_DEFAULT, flags, &time, nullptr, string.data(), string.size())
-			        >> checkWin32Result("allocateFormat", errorValue, 0);
-			string.erase(string.find(L'\0'));
-			return string;
-		};
+		//Format a whole column at once, appending the text of every row to column
+		template<typename Rows, typename GetTimeStamp>
+		void formatColumn(const Rows& rows, GetTimeStamp getTimeStamp, std::vector<std::wstring>& column) {
+			column.reserve(column.size() + std::size(rows));
+			for(const auto& row : rows) {
+				column.push_back(this->format(getTimeStamp(row)));
+			}
+		}
 
-		auto strings = std::vector<std::vector<std::wstring>> {};
-		for(const auto& replay : this->replayDetails) {
-			auto fileTime = unixTimeToFileTime(replay.timeStamp);
+	private:
+		static SYSTEMTIME toLocalTime(std::uint32_t timeStamp) {
+			auto fileTime = unixTimeToFileTime(timeStamp);
 			auto systemTime = SYSTEMTIME{};
 			FileTimeToSystemTime(&fileTime, &systemTime)
 			        >> checkWin32Result("FileTimeToSystemTime", errorValue, false);
 			auto localTime = SYSTEMTIME{};
 			SystemTimeToTzSpecificLocalTime(nullptr, &systemTime, &localTime)
 			        >> checkWin32Result("SystemTimeToTzSpecificLocalTime", errorValue, false);
+			return localTime;
+		}
+
+		template<typename Function>
+		static const std::wstring& getOrFormat(std::unordered_map<std::uint32_t, std::wstring>& cache, std::uint32_t key,
+		                                       Function function, DWORD flags, const SYSTEMTIME& time) {
+			auto cached = cache.find(key);
+			if(cached != cache.end()) {
+				return cached->second;
+			}
+
+			//most texts fit into a small buffer, so they don't need another call to get their size first
+			auto buffer = std::array<wchar_t, 128>{};
+			auto length = function(LOCALE_USER_DEFAULT, flags, &time, nullptr, buffer.data(), static_cast<int>(buffer.size()));
+			if(length > 0) {
+				return cache.emplace(key, std::wstring{buffer.data(), static_cast<std::size_t>(length - 1)}).first->second;
+			}
+
+			auto size = function(LOCALE_USER_DEFAULT, flags, &time, nullptr, nullptr, 0)
+			            >> checkWin32Result("getOrFormat", errorValue, 0);
+			auto string = std::wstring{static_cast<std::size_t>(size), {}, std::wstring::allocator_type{}};
+			function(LOCALE_USER_DEFAULT, flags, &time, nullptr, string.data(), size)
+			        >> checkWin32Result("getOrFormat", errorValue, 0);
+			string.erase(string.find(L'\0'));
+			return cache.emplace(key, std::move(string)).first->second;
+		}
+
+		std::unordered_map<std::uint32_t, std::wstring> texts; //keyed by minutes since 1970
+		std::unordered_map<std::uint32_t, std::wstring> dates;
+		std::unordered_map<std::uint32_t, std::wstring> times;
+};
+
+struct ReplaysAndModsData {
+	//Case-folded texts of columns which are compared case-insensitively, computed once when rows are added
+	struct ReplaySortKeys {
+		std::wstring replayName;
+		std::wstring modName;
+	};
+	struct ModSortKeys {
+		std::wstring modName;
+		std::wstring version;
+	};
+
+	void clearReplays() {
+		this->replayDetails.clear();
+		this->replaySortKeys.clear();
+		this->replayDates.clear();
+		this->replayOrder.reset(0);
+		this->replaySearch.clear();
+	}
+
+	void appendReplays(std::vector<ReplaysAndMods::ReplayDetails>&& replays) {
+		this->timeStampFormatter.formatColumn(replays, [](const auto& replay) { return replay.timeStamp; }, this->replayDates);
+		for(auto& replay : replays) {
+			this->replaySortKeys.push_back(ReplaySortKeys{foldCase(replay.replayName), foldCase(replay.modName)});
+			this->replayDetails.emplace_back(std::move(replay));
+		}
+		this->updateReplaySearch();
+		this->replayOrder.append(replays.size(), [this](std::size_t index) {
+			return this->replaySearch.matches(index, this->replayFilter);
+		});
+	}
 
-			auto date = allocateFormat(GetDateFormatW, DATE_LONGDATE, localTime);
-			auto time = allocateFormat(GetTimeFormatW, TIME_NOSECONDS, localTime);
+	//Only show replays matching every word of filter, an empty filter shows all replays
+	template<typename Less>
+	void filterReplays(std::wstring filter, Less less) {
+		this->replayFilter = std::move(filter);
+		if(this->replayFilter.empty()) {
+			this->replayOrder.clearFilter(less);
+			return;
+		}
+		this->replayOrder.filter(this->replaySearch.search(this->replayFilter), less);
+	}
 
-			auto gameVersion = std::to_wstring(replay.gameVersion.first) + L'.' + std::to_wstring(replay.gameVersion.second);
-			strings.emplace_back(std::vector{replay.replayName, replay.modName, std::move(gameVersion)});
-			strings.back().emplace_back(date + L' ' + time);
+	//Replays are indexed as they are loaded, so typing in filter box never waits for it
+	void updateReplaySearch() {
+		for(auto index = this->replaySearch.size(); index < this->replayDetails.size(); ++index) {
+			const auto& replay = this->replayDetails[index];
+			auto fields = std::vector<std::wstring_view>{replay.replayName, replay.title, replay.map, replay.modName, replay.description};
+			fields.insert(fields.end(), replay.players.begin(), replay.players.end());
+			this->replaySearch.add(fields);
 		}
-		return strings;
 	}
 
-	std::vector<std::vector<std::wstring>> modDetailsToStrings() const {
-		auto strings = std::vector<std::vector<std::wstring>> {};
-		for(const auto& [fullPath, modName, modVersion] : this->modDetails) {
-			strings.emplace_back(std::vector{modName, modVersion});
+	void setMods(std::vector<ReplaysAndMods::ModDetails>&& mods) {
+		this->modSortKeys.clear();
+		for(const auto& mod : mods) {
+			this->modSortKeys.push_back(ModSortKeys{foldCase(mod.modName), foldCase(mod.version)});
+		}
+		this->modDetails = std::move(mods);
+		this->modOrder.reset(this->modDetails.size());
+	}
+
+	bool isReplayLess(ID column, std::size_t a, std::size_t b) const {
+		switch(column) {
+			case replayListReplayName:
+				return this->replaySortKeys[a].replayName < this->replaySortKeys[b].replayName;
+			case replayListModName:
+				return this->replaySortKeys[a].modName < this->replaySortKeys[b].modName;
+			case replayListGameVersion:
+				return this->replayDetails[a].gameVersion < this->replayDetails[b].gameVersion;
+			case replayListDate:
+				return this->replayDetails[a].timeStamp < this->replayDetails[b].timeStamp;
+			default:
+				return false;
+		}
+	}
+
+	bool isModLess(ID column, std::size_t a, std::size_t b) const {
+		switch(column) {
+			case modListModName:
+				return this->modSortKeys[a].modName < this->modSortKeys[b].modName;
+			case modListModVersion:
+				return this->modSortKeys[a].version < this->modSortKeys[b].version;
+			default:
+				return false;
+		}
+	}
+
+	//Cells which aren't stored as text, such as game version, are formatted into this buffer
+	using CellBuffer = std::array<wchar_t, 32>;
+
+	//Text of a cell of replay list, only valid until the replay list or buffer is changed
+	std::wstring_view getReplayCell(std::size_t index, ID column, CellBuffer& buffer) const {
+		const auto& replay = this->replayDetails.at(index);
+		switch(column) {
+			case replayListReplayName:
+				return replay.replayName;
+			case replayListModName:
+				return replay.modName;
+			case replayListGameVersion: {
+				auto length = std::swprintf(buffer.data(), buffer.size(), L"%u.%u",
+				                            static_cast<unsigned>(replay.gameVersion.first), static_cast<unsigned>(replay.gameVersion.second));
+				return {buffer.data(), static_cast<std::size_t>(std::max(length, 0))};
+			}
+			case replayListDate:
+				return this->replayDates.at(index);
+			default:
+				return {};
+		}
+	}
+
+	std::wstring_view getModCell(std::size_t index, ID column) const {
+		const auto& mod = this->modDetails.at(index);
+		switch(column) {
+			case modListModName:
+				return mod.modName;
+			case modListModVersion:
+				return mod.version;
+			default:
+				return {};
 		}
-		return strings;
 	}
 
 	std::wstring getReplayDescription(std::size_t index, const LanguageData& languageData) const {
@@ -1046,13 +1232,103 @@ struct ReplaysAndModsData {
 	}
 
 	std::vector<ReplaysAndMods::ReplayDetails> replayDetails;
+	std::vector<ReplaySortKeys> replaySortKeys;
+	std::vector<std::wstring> replayDates; //formatted once when replays are added
+	TimeStampFormatter timeStampFormatter; //kept when replays are reloaded, since timestamps don't change their texts
+	ListOrder replayOrder; //rows of replay list, as indices of replayDetails
+	SearchIndex replaySearch;
+	std::wstring replayFilter;
 	std::vector<ReplaysAndMods::ModDetails> modDetails;
+	std::vector<ModSortKeys> modSortKeys;
+	ListOrder modOrder;    //rows of mod list, as indices of modDetails
+};
+
+//Replays are loaded by a background thread, so the Game Browser can show them while the others are still being loaded.
+//replaysLoadedMessage is posted to the window whenever a batch of replays can be taken by takeBatch().
+class ReplayLoader {
+	public:
+		struct Batch {
+			std::vector<ReplaysAndMods::ReplayDetails> replays;
+			std::size_t loaded = 0;
+			std::size_t total = 0;
+			bool finished = false;
+		};
+
+		static constexpr auto replaysLoadedMessage = UINT{WM_APP + 1};
+
+		ReplayLoader() = default;
+		ReplayLoader(const ReplayLoader&) = delete;
+		ReplayLoader& operator=(const ReplayLoader&) = delete;
+
+		~ReplayLoader() {
+			this->cancel();
+		}
+
+		void start(HWND window) {
+			this->cancel();
+			this->cancelled = false;
+			this->thread = std::thread{[this, window] { this->load(window); }};
+		}
+
+		//Stop loading and discard replays which haven't been taken
+		void cancel() {
+			this->cancelled = true;
+			if(this->thread.joinable()) {
+				this->thread.join();
+			}
+			auto lock = std::lock_guard{this->mutex};
+			this->pending = Batch{};
+			this->error = nullptr;
+		}
+
+		//Replays loaded since the last call, with the latest progress; rethrows the exception which stopped loading
+		Batch takeBatch() {
+			auto lock = std::lock_guard{this->mutex};
+			if(this->error) {
+				std::rethrow_exception(std::exchange(this->error, nullptr));
+			}
+			auto batch = Batch{std::move(this->pending.replays), this->pending.loaded, this->pending.total, this->pending.finished};
+			this->pending.replays.clear();
+			return batch;
+		}
+
+	private:
+		void load(HWND window) {
+			auto publish = [this, window](auto function) {
+				{
+					auto lock = std::lock_guard{this->mutex};
+					function();
+				}
+				PostMessageW(window, replaysLoadedMessage, 0, 0);
+			};
+			try {
+				auto onBatch = [this, &publish](std::vector<ReplaysAndMods::ReplayDetails>&& replays, const std::vector<std::size_t>&, std::size_t loaded, std::size_t total) {
+					publish([this, &replays, loaded, total] {
+						auto& pending = this->pending.replays;
+						pending.insert(pending.end(), std::make_move_iterator(replays.begin()), std::make_move_iterator(replays.end()));
+						this->pending.loaded = loaded;
+						this->pending.total = total;
+					});
+				};
+				ReplaysAndMods::loadAllReplayDetails(onBatch, this->cancelled);
+				publish([this] { this->pending.finished = true; });
+			}
+			catch(...) {
+				publish([this] { this->error = std::current_exception(); });
+			}
+		}
+
+		std::thread thread;
+		std::atomic<bool> cancelled{false};
+		std::mutex mutex;
+		Batch pending;
+		std::exception_ptr error;
 };
 
 std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstring& ra3Path, HICON icon, const LanguageData& languageData) {
 	using std::pair;
 	static constexpr auto tabs = {replays, mods};
-	static constexpr auto replaySubWindows = {replayList, replayDescription, fixReplay, replayFolder};
+	static constexpr auto replaySubWindows = {replayFilter, replayList, replayDescription, fixReplay, replayFolder};
 	static constexpr auto modSubWindows = {modList, modFolder};
 	static constexpr auto tabSubWindows = {pair{replays, replaySubWindows}, pair{mods, modSubWindows}};
 	static constexpr auto replayListColumns = {pair{replayListReplayName, 0.52}, pair{replayListModName, 0.14}, pair{replayListGameVersion, 0.11}, pair{replayListDate, 0.23}};
@@ -1063,6 +1339,7 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 	constexpr auto buttonHeight = 30;
 	constexpr auto buttonPadding = 5;
 	constexpr auto replayDescriptionHeight = 110;
+	constexpr auto replayFilterHeight = 22;
 
 	static constexpr auto bannerRect = RECT{0, 0, 640, 100};
 	static constexpr auto clientArea = RECT{0, 0, rectWidth(bannerRect), 540};
@@ -1078,7 +1355,7 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 
 	handlers[WM_INITDIALOG] = [controlCenter, icon, &languageData, &font](HWND dialogBox, WPARAM wParam, LPARAM lParam) {
 		myBeginDialog(dialogBox, getText(languageData, gameBrowser), icon, controlCenter,
-		              ICC_STANDARD_CLASSES | ICC_TAB_CLASSES | ICC_LISTVIEW_CLASSES, clientArea);
+		              ICC_STANDARD_CLASSES | ICC_TAB_CLASSES | ICC_LISTVIEW_CLASSES | ICC_PROGRESS_CLASS, clientArea);
 
 		auto tab = createControl(dialogBox, gameBrowserTabs, WC_TABCONTROLW, {},
 		                         WS_VISIBLE, 0, 0, page.top, rectWidth(page), rectHeight(page)).release();
@@ -1115,7 +1392,14 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 			buttonOffset += buttonWidth + buttonPadding;
 		}
 
+		//filter box is above replay list
+		auto filterBox = createControl(dialogBox, replayFilter, WC_EDITW, {},
+		                               ES_AUTOHSCROLL, WS_EX_CLIENTEDGE,
+		                               page.left, page.top, rectWidth(page), replayFilterHeight).release();
+		SendMessageW(filterBox, EM_SETCUEBANNER, true, reinterpret_cast<LPARAM>(getText(languageData, replayFilter).c_str()));
+
 		auto replayListRect = page;
+		replayListRect.top = page.top + replayFilterHeight;
 		replayListRect.bottom = page.bottom - replayDescriptionHeight;
 		createListView(dialogBox, replayList, replayListColumns, replayListRect, languageData).release();
 
@@ -1127,13 +1411,18 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 		              0, 0, page.right - 1 * (buttonPadding + buttonWidth), page.bottom + buttonPadding, buttonWidth, buttonHeight).release();
 		createControl(dialogBox, fixReplay, WC_BUTTONW, getText(languageData, fixReplay).c_str(),
 		              0, 0, page.right - 2 * (buttonPadding + buttonWidth), page.bottom + buttonPadding, buttonWidth, buttonHeight).release();
+		//between the bottom buttons and the buttons of replay tab, only shown while replays are being loaded
+		auto progressLeft = buttonPadding * 2 + static_cast<int>(bottomButtons.size()) * (buttonWidth + buttonPadding) + buttonPadding;
+		auto progressRight = page.right - 2 * (buttonPadding + buttonWidth) - buttonPadding * 2;
+		createControl(dialogBox, replayLoadingProgress, PROGRESS_CLASSW, {},
+		              0, 0, progressLeft, page.bottom + buttonPadding * 2, progressRight - progressLeft, buttonHeight - buttonPadding * 2).release();
 
 		createListView(dialogBox, modList, modListColumns, page, languageData).release();
 
 		createControl(dialogBox, modFolder, WC_BUTTONW, getText(languageData, modFolder).c_str(),
 		              0, 0, page.right - 1 * (buttonPadding + buttonWidth), page.bottom + buttonPadding, buttonWidth, buttonHeight).release();
 
-		for(auto id : {gameBrowserLaunchGame, gameBrowserCancel, replayDescription, fixReplay, replayFolder, modFolder}) {
+		for(auto id : {gameBrowserLaunchGame, gameBrowserCancel, replayFilter, replayDescription, fixReplay, replayFolder, modFolder}) {
 			SendMessageW(getControlByID(dialogBox, id), WM_SETFONT, reinterpret_cast<WPARAM>(font.get()), true);
 		}
 
@@ -1155,6 +1444,7 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 
 	auto replaysAndMods = ReplaysAndModsData{};
 	auto launchOptions = std::optional<LaunchOptions> {};
+	auto replayLoader = ReplayLoader{};
 
 	auto getCurrentTabID = [](HWND dialogBox) {
 		auto selected = SendMessageW(getControlByID(dialogBox, gameBrowserTabs), TCM_GETCURSEL, 0, 0)
@@ -1166,61 +1456,62 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 	};
 
 	auto updateListWindow = [&replaysAndMods](HWND dialogBox, ID id) {
-		auto window = HWND{nullptr};
-		auto strings = std::vector<std::vector<std::wstring>> {};
 		if(id == replays) {
-			window = getControlByID(dialogBox, replayList);
-			strings = replaysAndMods.replayDetailsToStrings();
+			refreshListView(getControlByID(dialogBox, replayList), replaysAndMods.replayOrder.size());
 		}
 		if(id == mods) {
-			window = getControlByID(dialogBox, modList);
-			strings = replaysAndMods.modDetailsToStrings();
+			refreshListView(getControlByID(dialogBox, modList), replaysAndMods.modOrder.size());
 		}
-		replaceListView(window, strings);
 	};
 
-	auto sortCurrentList = [&replaysAndMods, getCurrentTabID, updateListWindow](HWND dialogBox, std::size_t columnIndex) {
-		using namespace std::placeholders;
-		auto toggleSort = [](auto& detailsVector, auto memberAddress, auto compare) {
-			auto compareMember = std::bind(compare, std::bind(memberAddress, _1), std::bind(memberAddress, _2));
-			if(std::is_sorted(std::begin(detailsVector), std::end(detailsVector), compareMember)) {
-				std::sort(std::rbegin(detailsVector), std::rend(detailsVector), compareMember);
-			}
-			else {
-				std::sort(std::begin(detailsVector), std::end(detailsVector), compareMember);
-			}
-		};
+	auto getDisplayText = [&replaysAndMods](NMLVDISPINFOW& information) {
+		auto& item = information.item;
+		auto row = static_cast<std::size_t>(item.iItem);
+		auto column = static_cast<std::size_t>(item.iSubItem);
+		if(information.hdr.idFrom == replayList and row < replaysAndMods.replayOrder.size() and column < replayListColumns.size()) {
+			auto buffer = ReplaysAndModsData::CellBuffer{};
+			setDisplayText(item, replaysAndMods.getReplayCell(replaysAndMods.replayOrder.at(row), std::begin(replayListColumns)[column].first, buffer));
+		}
+		if(information.hdr.idFrom == modList and row < replaysAndMods.modOrder.size() and column < modListColumns.size()) {
+			setDisplayText(item, replaysAndMods.getModCell(replaysAndMods.modOrder.at(row), std::begin(modListColumns)[column].first));
+		}
+	};
 
+	auto isReplayLess = [&replaysAndMods](std::size_t columnIndex, std::size_t a, std::size_t b) {
+		return replaysAndMods.isReplayLess(std::begin(replayListColumns)[columnIndex].first, a, b);
+	};
+	auto isModLess = [&replaysAndMods](std::size_t columnIndex, std::size_t a, std::size_t b) {
+		return replaysAndMods.isModLess(std::begin(modListColumns)[columnIndex].first, a, b);
+	};
+
+	//Clicking a column sorts by that column, shift-clicking adds it as another sort key, for example mod, then date
+	auto sortCurrentList = [&replaysAndMods, getCurrentTabID, updateListWindow, isReplayLess, isModLess](HWND dialogBox, std::size_t columnIndex) {
+		auto addToKeys = GetKeyState(VK_SHIFT) < 0;
 		auto currentID = getCurrentTabID(dialogBox);
 		if(currentID == replays) {
 			if(columnIndex >= replayListColumns.size()) { throw std::out_of_range("columnIndex > replayListColumns.size()"); }
-			auto columnIs = [columnIndex](ID id) { return std::begin(replayListColumns)[columnIndex].first == id; };
-			auto sortReplays = std::bind(toggleSort, std::ref(replaysAndMods.replayDetails), _1, _2);
-			using Details = ReplaysAndMods::ReplayDetails;
-
-			if(columnIs(replayListReplayName)) sortReplays(&Details::replayName, StringLess{});
-			if(columnIs(replayListModName)) sortReplays(&Details::modName, StringLess{});
-			if(columnIs(replayListGameVersion)) sortReplays(&Details::gameVersion, std::less{});
-			if(columnIs(replayListDate)) sortReplays(&Details::timeStamp, std::less{});
+			replaysAndMods.replayOrder.sortBy(columnIndex, addToKeys, isReplayLess);
 		}
 
 		if(currentID == mods) {
 			if(columnIndex >= modListColumns.size()) { throw std::out_of_range("columnIndex > modListColumns.size()"); }
-			auto columnIs = [columnIndex](ID id) { return std::begin(modListColumns)[columnIndex].first == id; };
-			auto sortModStrings = std::bind(toggleSort, std::ref(replaysAndMods.modDetails), _1, StringLess{});
-			using Details = ReplaysAndMods::ModDetails;
-
-			if(columnIs(modListModName)) sortModStrings(&Details::modName);
-			if(columnIs(modListModVersion)) sortModStrings(&Details::version);
+			replaysAndMods.modOrder.sortBy(columnIndex, addToKeys, isModLess);
 		}
 
 		updateListWindow(dialogBox, currentID);
 	};
 
-	auto setSelected = [&languageData, &replaysAndMods, &launchOptions, getCurrentTabID](HWND dialogBox, std::size_t index) {
+	//Called every time the text of filter box is changed
+	auto filterReplays = [&replaysAndMods, isReplayLess](HWND dialogBox) {
+		replaysAndMods.filterReplays(getWindowText(getControlByID(dialogBox, replayFilter)), isReplayLess);
+		refreshListView(getControlByID(dialogBox, replayList), replaysAndMods.replayOrder.size());
+	};
+
+	auto setSelected = [&languageData, &replaysAndMods, &launchOptions, getCurrentTabID](HWND dialogBox, std::size_t row) {
 		auto currentID = getCurrentTabID(dialogBox);
 
-		if(currentID == replays and index < replaysAndMods.replayDetails.size()) {
+		if(currentID == replays and row < replaysAndMods.replayOrder.size()) {
+			auto index = replaysAndMods.replayOrder.at(row);
 			const auto& replay = replaysAndMods.replayDetails[index];
 			launchOptions = {LaunchOptions::replay, replay.fullPath};
 			//update replay description
@@ -1230,14 +1521,14 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 			auto needFix = not replay.finalTimeCode.has_value();
 			EnableWindow(getControlByID(dialogBox, fixReplay), needFix);
 		}
-		if(currentID == mods and index < replaysAndMods.modDetails.size()) {
-			const auto& mod = replaysAndMods.modDetails[index];
+		if(currentID == mods and row < replaysAndMods.modOrder.size()) {
+			const auto& mod = replaysAndMods.modDetails[replaysAndMods.modOrder.at(row)];
 			launchOptions = {LaunchOptions::mod, mod.fullPath};
 		}
 		EnableWindow(getControlByID(dialogBox, gameBrowserLaunchGame), true);
 	};
 
-	auto initializeTab = [&replaysAndMods, &launchOptions, getCurrentTabID, updateListWindow](HWND dialogBox) {
+	auto initializeTab = [&replaysAndMods, &launchOptions, &replayLoader, getCurrentTabID, updateListWindow, filterReplays](HWND dialogBox) {
 		//disable launch game button
 		EnableWindow(getControlByID(dialogBox, gameBrowserLaunchGame), false);
 		EnableWindow(getControlByID(dialogBox, fixReplay), false);
@@ -1257,18 +1548,51 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 			}
 		}
 
+		replayLoader.cancel();
+		auto progress = getControlByID(dialogBox, replayLoadingProgress);
+		ShowWindow(progress, SW_HIDE);
 		if(currentID == replays) {
-			replaysAndMods.replayDetails = ReplaysAndMods::getAllReplayDetails();
+			//replays will be appended by replaysLoadedMessage
+			replaysAndMods.clearReplays();
+			filterReplays(dialogBox); //replays will be filtered as they are loaded
+			SendMessageW(progress, PBM_SETPOS, 0, 0);
+			ShowWindow(progress, SW_SHOW);
+			replayLoader.start(dialogBox);
 		}
 		if(currentID == mods) {
-			replaysAndMods.modDetails = ReplaysAndMods::getModSkudefs();
+			replaysAndMods.setMods(ReplaysAndMods::getModSkudefs());
 		}
 
 		updateListWindow(dialogBox, currentID);
 		return TRUE;
 	};
 
-	auto fixReplayWorker = [&languageData, &launchOptions, initializeTab](HWND dialogBox) {
+	handlers[ReplayLoader::replaysLoadedMessage] = [&replaysAndMods, &replayLoader, getCurrentTabID, isReplayLess](HWND dialogBox, WPARAM, LPARAM) {
+		auto batch = replayLoader.takeBatch();
+		if(getCurrentTabID(dialogBox) != replays) {
+			return TRUE; //posted before loading was cancelled
+		}
+		replaysAndMods.appendReplays(std::move(batch.replays));
+		auto& order = replaysAndMods.replayOrder;
+		if(batch.finished and not order.sortKeys().empty()) {
+			//replays loaded after the list was sorted have been appended at the end
+			order.sort(isReplayLess);
+			refreshListView(getControlByID(dialogBox, replayList), order.size());
+		}
+		else {
+			//rows are only appended, so selection and scroll position are kept
+			SendMessageW(getControlByID(dialogBox, replayList), LVM_SETITEMCOUNT, order.size(), LVSICF_NOINVALIDATEALL|LVSICF_NOSCROLL)
+			        >> checkWin32Result("SendMessageW LVM_SETITEMCOUNT", errorValue, false);
+		}
+
+		auto progress = getControlByID(dialogBox, replayLoadingProgress);
+		SendMessageW(progress, PBM_SETRANGE32, 0, batch.total);
+		SendMessageW(progress, PBM_SETPOS, batch.loaded, 0);
+		ShowWindow(progress, batch.finished ? SW_HIDE : SW_SHOW);
+		return TRUE;
+	};
+
+	auto fixReplayWorker = [&languageData, &launchOptions, &replayLoader, initializeTab](HWND dialogBox) {
 		if(not launchOptions.has_value() or launchOptions->loadFileType != LaunchOptions::replay) {
 			return;
 		}
@@ -1280,6 +1604,7 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 		if(fix != IDYES) {
 			return;
 		}
+		replayLoader.cancel(); //the replay may be being parsed, and all replays will be loaded again anyway
 		try {
 			fixReplayByFileName(launchOptions->fileToBeLoaded);
 			notifyFixReplaySucceeded(languageData);
@@ -1303,7 +1628,7 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 		return TRUE;
 	};
 
-	handlers[WM_NOTIFY] = [sortCurrentList, setSelected, launchGame, initializeTab](HWND dialogBox, WPARAM, LPARAM dataHeaderAddress) {
+	handlers[WM_NOTIFY] = [sortCurrentList, setSelected, launchGame, initializeTab, getDisplayText](HWND dialogBox, WPARAM, LPARAM dataHeaderAddress) {
 		auto dataHeader = reinterpret_cast<const NMHDR*>(dataHeaderAddress);
 
 		if(dataHeader->idFrom == gameBrowserTabs) {
@@ -1314,6 +1639,10 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 		}
 
 		if(dataHeader->idFrom == replayList or dataHeader->idFrom == modList) {
+			if(dataHeader->code == LVN_GETDISPINFOW) {
+				getDisplayText(*reinterpret_cast<NMLVDISPINFOW*>(dataHeaderAddress));
+				return TRUE;
+			}
 			if(dataHeader->code == LVN_COLUMNCLICK) {
 				auto listViewData = reinterpret_cast<const NMLISTVIEW*>(dataHeader);
 				sortCurrentList(dialogBox, listViewData->iSubItem);
@@ -1337,9 +1666,13 @@ std::optional<LaunchOptions> runGameBrowser(HWND controlCenter, const std::wstri
 		return FALSE;
 	};
 
-	handlers[WM_COMMAND] = [fixReplayWorker, launchGame, cancel](HWND dialogBox, WPARAM codeAndIdentifier, LPARAM controlHandle) {
+	handlers[WM_COMMAND] = [fixReplayWorker, launchGame, cancel, filterReplays](HWND dialogBox, WPARAM codeAndIdentifier, LPARAM controlHandle) {
 		auto notificationCode = HIWORD(codeAndIdentifier);
 		auto identifier = LOWORD(codeAndIdentifier);
+		if(notificationCode == EN_CHANGE and identifier == replayFilter) {
+			filterReplays(dialogBox);
+			return TRUE;
+		}
 		if(notificationCode == BN_CLICKED) {
 			if(identifier == gameBrowserLaunchGame) {
 				launchGame(dialogBox);
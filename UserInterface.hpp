@@ -23,6 +23,9 @@ struct LaunchOptions {
 	std::wstring extraCommandLine;
 };
 
+//Resolve every user interface string of languageData once, built-in strings are used for missing ones.
+//Must be called after loading a LanguageData, unresolved LanguageData falls back to built-in English strings.
+void resolveTexts(LanguageData& languageData);
 void displayErrorMessage(const std::exception& error, const LanguageData& languageData);
 void notifyCantUpdate(const LanguageData& languageData);
 void notifyIsNotReplay(const LanguageData& languageData);
@@ -6,6 +6,7 @@
 #include <string>
 #include <string_view>
 #include <optional>
+#include <cstdint>
 #include <system_error>
 #include <functional>
 #include <exception>
@@ -230,6 +231,14 @@ namespace Windows {
 		return GetDlgCtrlID(childWindow) >> checkWin32Result("GetDlgCtrlID", errorValue, 0);
 	}
 
+	inline std::wstring getWindowText(HWND windowHandle) {
+		auto length = GetWindowTextLengthW(windowHandle);
+		auto windowString = std::wstring{static_cast<std::size_t>(length + 1), L'\0', std::wstring::allocator_type{}};
+		auto realLength = GetWindowTextW(windowHandle, windowString.data(), length + 1);
+		windowString.resize(realLength);
+		return windowString;
+	}
+
 	struct ModalDialogBox {
 		using MessageHandler = std::function<INT_PTR(HWND, WPARAM, LPARAM)>;
 		using HandlerTable = std::unordered_map<UINT, MessageHandler>;
@@ -603,6 +612,36 @@ namespace Windows {
 		return result.QuadPart;
 	}
 
+	struct FileViewUnmapper {
+		using pointer = const char*;
+		void operator()(pointer view) const noexcept {
+			UnmapViewOfFile(view);
+		}
+	};
+
+	using FileView = std::unique_ptr<const char, FileViewUnmapper>;
+
+	//Read-only view of a whole file, [begin(), end()) can be used directly as a contiguous byte range
+	struct MappedFile {
+		const char* begin() const noexcept { return this->view.get(); }
+		const char* end() const noexcept { return this->view.get() + this->size; }
+		Handle mapping;
+		FileView view;
+		std::size_t size;
+	};
+
+	inline MappedFile mapFile(HANDLE fileHandle) {
+		auto size = getFileSize(fileHandle);
+		if(size == 0) {
+			return MappedFile{nullptr, nullptr, 0}; //empty files cannot be mapped
+		}
+		auto mapping = Handle{CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr)
+		                      >> checkWin32Result("CreateFileMappingW", errorValue, nullptr)};
+		auto view = FileView{static_cast<const char*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0))
+		                     >> checkWin32Result("MapViewOfFile", errorValue, nullptr)};
+		return MappedFile{std::move(mapping), std::move(view), size};
+	}
+
 	inline bool isDirectory(const std::wstring& path) {
 		auto attributes = GetFileAttributesW(path.c_str());
 		return (attributes != INVALID_FILE_ATTRIBUTES) and (attributes bitand FILE_ATTRIBUTE_DIRECTORY);
@@ -622,21 +661,28 @@ namespace Windows {
 
 	using FindHandle = std::unique_ptr<HANDLE, FindCloser>;
 
-	template<typename Predicate>
-	inline std::vector<std::wstring> findAllMatching(const std::wstring& path, Predicate predicate) {
+	struct FileInformation {
+		std::wstring fileName;
+		std::uint64_t fileSize;
+		std::uint64_t lastWriteTime;
+	};
+
+	template<typename Predicate, typename Transform>
+	inline auto findAllMatching(const std::wstring& path, Predicate predicate, Transform transform) {
+		using ResultType = std::decay_t<std::invoke_result_t<Transform, const WIN32_FIND_DATAW&>>;
 		auto data = WIN32_FIND_DATAW{};
 		auto rawHandle = FindFirstFileW(path.c_str(), &data);
 		auto lastError = GetLastError();
 		if(rawHandle == INVALID_HANDLE_VALUE and lastError == ERROR_FILE_NOT_FOUND) {
-			return {};
+			return std::vector<ResultType> {};
 		}
 		auto handle = FindHandle {rawHandle >> checkWin32Result(("FindFirstFile [" + toBytes(path) + ']').c_str(), errorValue, INVALID_HANDLE_VALUE, lastError)};
 
-		auto fileNames = std::vector<std::wstring> {};
+		auto results = std::vector<ResultType> {};
 		auto nextFileExist = false;
 		do {
 			if(predicate(data)) {
-				fileNames.emplace_back(data.cFileName);
+				results.emplace_back(transform(data));
 			}
 
 			nextFileExist = FindNextFileW(handle.get(), &data);
@@ -646,13 +692,28 @@ namespace Windows {
 			}
 		}
 		while(nextFileExist);
-		return fileNames;
+		return results;
+	}
+
+	template<typename Predicate>
+	inline std::vector<std::wstring> findAllMatching(const std::wstring& path, Predicate predicate) {
+		return findAllMatching(path, predicate, [](const WIN32_FIND_DATAW& data) { return std::wstring{data.cFileName}; });
 	}
 
 	inline std::vector<std::wstring> findAllMatchingFiles(const std::wstring& path) {
 		return findAllMatching(path, [](const WIN32_FIND_DATAW& data) { return data.dwFileAttributes xor FILE_ATTRIBUTE_DIRECTORY; });
 	}
 
+	inline std::vector<FileInformation> findAllMatchingFilesWithInformation(const std::wstring& path) {
+		auto isFile = [](const WIN32_FIND_DATAW& data) { return data.dwFileAttributes xor FILE_ATTRIBUTE_DIRECTORY; };
+		auto toInformation = [](const WIN32_FIND_DATAW& data) {
+			auto combine = [](DWORD high, DWORD low) { return (static_cast<std::uint64_t>(high) << 32) bitor low; };
+			return FileInformation{data.cFileName, combine(data.nFileSizeHigh, data.nFileSizeLow),
+			                       combine(data.ftLastWriteTime.dwHighDateTime, data.ftLastWriteTime.dwLowDateTime)};
+		};
+		return findAllMatching(path, isFile, toInformation);
+	}
+
 	inline std::vector<std::wstring> findAllMatchingDirectories(const std::wstring& path) {
 		return findAllMatching(path, [](const WIN32_FIND_DATAW& data) { return data.dwFileAttributes bitand FILE_ATTRIBUTE_DIRECTORY; });
 	}
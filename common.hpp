@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <array>
 #include <type_traits>
 #include <iterator>
 #include <algorithm>
@@ -8,7 +9,15 @@
 #include <stdexcept>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <unordered_map>
 #include <locale>
+#include <optional>
+#include <Shlobj.h>
 #include "WindowsWrapper.hpp"
 #include "CSFParser.hpp"
 #include "ReplaysAndMods.hpp"
@@ -40,6 +49,15 @@ struct StringLess {
 	}
 };
 
+//Case-folded copy of string, comparing two of them with operator< gives the same result as StringLess
+inline std::wstring foldCase(std::wstring_view string) {
+	auto folded = std::wstring{string};
+	for(auto& character : folded) {
+		character = std::tolower(character, std::locale::classic());
+	}
+	return folded;
+}
+
 template<typename T>
 void readFile(HANDLE file, std::vector<T>& buffer, std::size_t count) {
 	buffer.resize(buffer.size() + count);
@@ -73,12 +91,12 @@ std::vector<T> readEntireFile(HANDLE file) {
 }
 
 template<typename T>
-void writeEntireFile(HANDLE file, const std::vector<T>& buffer) {
-	auto totalBytesWritten = typename std::vector<T>::size_type{0};
-	while(totalBytesWritten < buffer.size()) {
+void writeToFile(HANDLE file, const T* data, std::size_t count) {
+	auto totalBytesWritten = std::size_t{0};
+	while(totalBytesWritten < count * sizeof(T)) {
 		using namespace Windows;
 		auto bytesWritten = DWORD{};
-		WriteFile(file, buffer.data() + totalBytesWritten, buffer.size() - totalBytesWritten, &bytesWritten, nullptr)
+		WriteFile(file, reinterpret_cast<const char*>(data) + totalBytesWritten, count * sizeof(T) - totalBytesWritten, &bytesWritten, nullptr)
 		        >> checkWin32Result("WriteFile", errorValue, false);
 		totalBytesWritten += bytesWritten;
 
@@ -88,43 +106,241 @@ void writeEntireFile(HANDLE file, const std::vector<T>& buffer) {
 	}
 }
 
-inline void fixReplayByFileName(const std::wstring& fileName) {
-	using namespace Windows;
-	using namespace ReplaysAndMods;
-	auto fixedFileContent = std::vector<char> {};
+template<typename T>
+void writeEntireFile(HANDLE file, const std::vector<T>& buffer) {
+	writeToFile(file, buffer.data(), buffer.size());
+}
 
-	{
-		auto file = createFile(fileName, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE, OPEN_EXISTING);
-		auto fileSize = getFileSize(file.get());
-		const auto fileContent = readFile<char>(file.get(), fileSize);
-		fixedFileContent = fixReplay(Input::Range{std::begin(fileContent), std::end(fileContent)});
-	}
+//Collect bytes in a fixed size buffer, and write them into file when the buffer is full.
+//flush() must be called after the last byte has been written.
+class FileOutputBuffer {
+	public:
+		static constexpr auto bufferSize = std::size_t{64 * 1024};
 
-	auto outputName = fileName + L".RA3BARLAUNCHER_FIX_REPLAY" + replayExtension;
+		struct Iterator {
+			using value_type = void;
+			using difference_type = void;
+			using pointer = void;
+			using reference = void;
+			using iterator_category = std::output_iterator_tag;
+
+			Iterator& operator*() noexcept { return *this; }
+			Iterator& operator++() noexcept { return *this; }
+			Iterator& operator++(int) noexcept { return *this; }
+			Iterator& operator=(char byte) { this->output->put(byte); return *this; }
+
+			FileOutputBuffer* output;
+		};
+
+		explicit FileOutputBuffer(HANDLE file) : file{file}, buffer(bufferSize) { }
 
+		Iterator iterator() noexcept { return Iterator{this}; }
+
+		void put(char byte) {
+			if(this->size == this->buffer.size()) {
+				this->flush();
+			}
+			this->buffer[this->size] = byte;
+			++(this->size);
+		}
+
+		void flush() {
+			writeToFile(this->file, this->buffer.data(), this->size);
+			this->size = 0;
+		}
+
+	private:
+		HANDLE file;
+		std::vector<char> buffer;
+		std::size_t size = 0;
+};
+
+enum class ReplayFixMode {
+	inPlace, //cut off the damaged tail and append a footer, only the damaged tail is backed up
+	rewrite, //write a repaired copy and replace the original, the whole original is backed up
+};
+
+inline std::wstring getUnusedBackupFileName(const std::wstring& fileName, std::wstring_view extension) {
+	using namespace Windows;
 	auto backupFileName = fileName + L".original";
-	while(fileExists(backupFileName + replayExtension)) {
+	while(fileExists(backupFileName + std::wstring{extension})) {
 		backupFileName += L'l';
 	}
-	backupFileName += replayExtension;
+	return backupFileName + std::wstring{extension};
+}
+
+inline void rewriteReplay(const std::wstring& fileName) {
+	using namespace Windows;
+	using namespace ReplaysAndMods;
+
+	auto outputName = fileName + L".RA3BARLAUNCHER_FIX_REPLAY" + replayExtension;
+	auto backupFileName = getUnusedBackupFileName(fileName, replayExtension);
 
 	{
+		auto file = createFile(fileName, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE, OPEN_EXISTING);
+		auto mappedFile = mapFile(file.get());
 		auto output = createFile(outputName, GENERIC_WRITE, FILE_SHARE_READ|FILE_SHARE_WRITE, CREATE_NEW);
-		writeEntireFile(output.get(), fixedFileContent);
+		try {
+			auto outputBuffer = FileOutputBuffer{output.get()};
+			fixReplay(Input::ContiguousReader{mappedFile.begin(), mappedFile.end()}, outputBuffer.iterator());
+			outputBuffer.flush();
+		}
+		catch(...) {
+			output.reset();
+			DeleteFileW(outputName.c_str());
+			throw;
+		}
 	}
 
 	ReplaceFileW(fileName.c_str(), outputName.c_str(), backupFileName.c_str(), REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr)
 	        >> checkWin32Result("ReplaceFileW", errorValue, 0);
 }
 
+//Only the bytes after the last complete chunk are read, backed up and rewritten,
+//so the amount of I/O depends on the size of the damaged tail rather than the size of the replay.
+inline void repairReplayInPlace(const std::wstring& fileName) {
+	using namespace Windows;
+	using namespace ReplaysAndMods;
+
+	auto file = createFile(fileName, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ, OPEN_EXISTING);
+	auto validLength = std::size_t{0};
+	auto lastTimeCode = std::array<char, sizeof(std::uint32_t)> {};
+	auto backupFileName = std::wstring{};
+	{
+		//the view must be unmapped before the file can be truncated
+		auto mappedFile = mapFile(file.get());
+		auto repairPoint = findReplayRepairPoint(Input::ContiguousReader{mappedFile.begin(), mappedFile.end()});
+		if(repairPoint.hasValidFooter) {
+			return;
+		}
+		validLength = static_cast<std::size_t>(repairPoint.validEnd - mappedFile.begin());
+		lastTimeCode = repairPoint.lastTimeCode;
+
+		backupFileName = getUnusedBackupFileName(fileName, L".RA3BarLauncherTail");
+		auto backup = createFile(backupFileName, GENERIC_WRITE, FILE_SHARE_READ, CREATE_NEW);
+		try {
+			writeToFile(backup.get(), repairPoint.validEnd, mappedFile.end() - repairPoint.validEnd);
+		}
+		catch(...) {
+			backup.reset();
+			DeleteFileW(backupFileName.c_str());
+			throw;
+		}
+	}
+
+	//the footer overwrites the damaged bytes before the file is truncated,
+	//so if it cannot be written, the replay keeps its damaged tail instead of having no end at all
+	try {
+		setFilePointer(file.get(), static_cast<LONGLONG>(validLength), FILE_BEGIN);
+		auto outputBuffer = FileOutputBuffer{file.get()};
+		writeReplayFooter(lastTimeCode, outputBuffer.iterator());
+		outputBuffer.flush();
+		SetEndOfFile(file.get()) >> checkWin32Result("SetEndOfFile", errorValue, false);
+	}
+	catch(const std::exception& error) {
+		throw std::runtime_error(std::string{error.what()} + "\nThe damaged tail of the replay is backed up in " + toBytes(backupFileName));
+	}
+}
+
+inline void fixReplayByFileName(const std::wstring& fileName, ReplayFixMode mode = ReplayFixMode::inPlace) {
+	if(mode == ReplayFixMode::inPlace) {
+		repairReplayInPlace(fileName);
+	}
+	else {
+		rewriteReplay(fileName);
+	}
+}
+
 inline Windows::RegistryKey getRa3RegistryKey(HKEY base, REGSAM access = KEY_READ) {
 	return Windows::openRegistryKey(base, L"Software\\Electronic Arts\\Electronic Arts\\Red Alert 3", access | KEY_READ);
 }
 
+//Strings of a CSF file, which are only decoded when they are looked up for the first time.
+//They can also come from a compiled table, which is used without parsing the CSF file.
+//Copies share the same CSF data and decoded strings.
+class CSFStringTable {
+	public:
+		CSFStringTable() = default;
+
+		explicit CSFStringTable(Windows::MappedFile csf) : state{std::make_shared<State>()} {
+			this->state->mappedFile = std::move(csf);
+			this->index(this->state->mappedFile.begin(), this->state->mappedFile.end());
+		}
+
+		explicit CSFStringTable(std::vector<char> csf) : state{std::make_shared<State>()} {
+			this->state->buffer = std::move(csf);
+			this->index(this->state->buffer.data(), this->state->buffer.data() + this->state->buffer.size());
+		}
+
+		//The compiled table starts at compiledTableOffset of file, and extends to the end of file
+		CSFStringTable(Windows::MappedFile file, std::size_t compiledTableOffset) : state{std::make_shared<State>()} {
+			this->state->mappedFile = std::move(file);
+			auto image = Input::ContiguousReader{this->state->mappedFile.begin(), this->state->mappedFile.end()};
+			Input::ignore(image, compiledTableOffset);
+			this->state->compiledTable = MyCSF::CompiledTable{image};
+			if(Input::hasFailed(image)) {
+				throw std::invalid_argument("Failed to load compiled CSF table");
+			}
+		}
+
+		//Returned strings stay valid as long as the table or one of its copies exists
+		const std::wstring* find(std::wstring_view label) const {
+			if(not this->state) {
+				return nullptr;
+			}
+			if(this->state->compiledTable.has_value()) {
+				return this->findIn(*this->state->compiledTable, label);
+			}
+			return this->findIn(this->state->table, label);
+		}
+
+		//Image of a compiled table, only available for tables loaded from CSF files
+		std::vector<char> compile() const {
+			if(not this->state or this->state->compiledTable.has_value()) {
+				throw std::logic_error("CSFStringTable is already compiled");
+			}
+			return this->state->table.compile();
+		}
+
+	private:
+		struct State {
+			Windows::MappedFile mappedFile;
+			std::vector<char> buffer;
+			MyCSF::LazyTable table;
+			std::optional<MyCSF::CompiledTable> compiledTable;
+			std::mutex mutex;
+			std::unordered_map<const void*, std::wstring> decoded; //keyed by entries of table or compiledTable
+		};
+
+		template<typename Table>
+		const std::wstring* findIn(const Table& table, std::wstring_view label) const {
+			auto entry = table.find(label);
+			if(entry == nullptr) {
+				return nullptr;
+			}
+			auto lock = std::lock_guard{this->state->mutex};
+			auto [decoded, isNew] = this->state->decoded.try_emplace(entry);
+			if(isNew) {
+				decoded->second = table.decode(*entry);
+			}
+			return &decoded->second;
+		}
+
+		void index(const char* begin, const char* end) {
+			auto csf = Input::ContiguousReader{begin, end};
+			this->state->table = MyCSF::LazyTable{csf};
+			if(Input::hasFailed(csf)) {
+				throw std::invalid_argument("Failed to parse CSF file");
+			}
+		}
+
+		std::shared_ptr<State> state;
+};
+
 struct LanguageData {
-	using ContainerType = std::map<std::wstring, std::wstring, StringLess>;
 	std::wstring languageName;
-	ContainerType table;
+	CSFStringTable table;
+	std::vector<const std::wstring*> texts; //user interface strings indexed by their ID, filled by resolveTexts()
 };
 
 inline std::vector<std::wstring> getAllLanguages(const std::wstring& ra3Path) {
@@ -149,26 +365,216 @@ inline void setLanguageToRegistry(const std::wstring& language) {
 	catch(...) { }
 }
 
-template<typename InputIterator>
-LanguageData::ContainerType loadCSFStrings(InputIterator begin, InputIterator end) {
-	auto emplacer = [](LanguageData::ContainerType& container, std::pair<std::string, std::wstring>&& newValue) {
-		for(auto& character : newValue.first) {
-			character = std::tolower(character, std::locale::classic());
-		}
-		container.emplace_hint(std::end(container), Windows::toWide(newValue.first), std::move(newValue.second));
+/*
+	Language cache file format, all integers are little endian
+
+	struct LanguageCache {
+	    char[24];                  //string "RA3BAR LANGUAGE CACHE" padded with '\0'
+	    uint32_t;                  //version number
+	    uint64_t;                  //size of source CSF file
+	    uint64_t;                  //last write time of source CSF file
+	    MyCSF::CompiledTable;      //until the end of file, aligned to 4 bytes
 	};
-	return MyCSF::readCSF<LanguageData::ContainerType>(Input::Range{begin, end}, emplacer);
+*/
+inline constexpr auto languageCacheMagic = std::string_view{"RA3BAR LANGUAGE CACHE\0\0\0", 24};
+inline constexpr auto languageCacheVersion = std::uint32_t{1};
+inline constexpr auto languageCacheHeaderSize = languageCacheMagic.size() + sizeof(std::uint32_t) + sizeof(std::uint64_t) * 2;
+inline const auto languageCacheExtension = std::wstring{L".RA3BarLauncherLanguage"};
+
+inline std::wstring getLanguageCacheFileName(const std::wstring& languageName) {
+	using namespace Windows;
+	auto cacheFolder = std::wstring{MAX_PATH, {}, std::wstring::allocator_type{}};
+	auto getPathResult = SHGetFolderPathW(nullptr, CSIDL_LOCAL_APPDATA|CSIDL_FLAG_CREATE, nullptr, SHGFP_TYPE_CURRENT, cacheFolder.data());
+	if(getPathResult != S_OK) {
+		throw std::runtime_error("SHGetFolderPathW failed, error code " + std::to_string(getPathResult));
+	}
+	cacheFolder.resize(std::min(cacheFolder.size(), cacheFolder.find('\0')));
+	appendToFolder(cacheFolder, L"RA3BarLauncher");
+	//languages may be loaded by several threads, one of them may create the folder first
+	if(not isDirectory(cacheFolder) and not CreateDirectoryW(cacheFolder.c_str(), nullptr) and not isDirectory(cacheFolder)) {
+		throw std::runtime_error("Failed to create language cache folder");
+	}
+	return concatenatePath(cacheFolder, languageName + languageCacheExtension);
 }
 
-inline LanguageData loadLanguageData(const std::wstring& ra3Path, const std::wstring& languageName) {
+//Returns nothing if the cache does not exist, is corrupted, or does not match the source CSF file anymore
+inline std::optional<CSFStringTable> loadLanguageCache(const std::wstring& cacheFileName, const Windows::FileInformation& source) {
+	using namespace Windows;
+	try {
+		auto cache = mapFile(createFile(cacheFileName, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING).get());
+		auto header = Input::ContiguousReader{cache.begin(), cache.end()};
+		Input::readAndCheckMagic(header, languageCacheMagic);
+		auto version = Input::copyBytes<std::uint32_t>(header);
+		auto sourceSize = Input::copyBytes<std::uint64_t>(header);
+		auto sourceLastWriteTime = Input::copyBytes<std::uint64_t>(header);
+		if(Input::hasFailed(header) or version != languageCacheVersion
+		   or sourceSize != source.fileSize or sourceLastWriteTime != source.lastWriteTime) {
+			return std::nullopt;
+		}
+		return CSFStringTable{std::move(cache), languageCacheHeaderSize};
+	}
+	catch(...) { } //cache will be rebuilt from the CSF file
+	return std::nullopt;
+}
+
+inline void saveLanguageCache(const std::wstring& cacheFileName, const Windows::FileInformation& source, const CSFStringTable& table) {
+	using namespace Windows;
+	try {
+		auto content = std::vector<char>{languageCacheMagic.begin(), languageCacheMagic.end()};
+		auto out = std::back_inserter(content);
+		out = std::copy_n(reinterpret_cast<const char*>(&languageCacheVersion), sizeof(languageCacheVersion), out);
+		out = std::copy_n(reinterpret_cast<const char*>(&source.fileSize), sizeof(source.fileSize), out);
+		out = std::copy_n(reinterpret_cast<const char*>(&source.lastWriteTime), sizeof(source.lastWriteTime), out);
+		auto image = table.compile();
+		content.insert(content.end(), image.begin(), image.end());
+
+		auto temporaryFileName = cacheFileName + L".tmp";
+		{
+			auto file = createFile(temporaryFileName, GENERIC_WRITE, 0, CREATE_ALWAYS);
+			writeEntireFile(file.get(), content);
+		}
+		MoveFileExW(temporaryFileName.c_str(), cacheFileName.c_str(), MOVEFILE_REPLACE_EXISTING)
+		        >> checkWin32Result("MoveFileExW", errorValue, false);
+	}
+	catch(...) { } //cache is only an optimization, failing to save it is not fatal
+}
+
+//A compiled cache of the CSF file is used if it is still up to date, otherwise the CSF file is parsed and the cache is rebuilt.
+//Unlike loadLanguageData, it doesn't change the language in registry, so it can be called from any thread.
+//If cancelled becomes true, the remaining steps are skipped and nothing is returned.
+inline std::optional<CSFStringTable> loadLanguageTable(const std::wstring& ra3Path, const std::wstring& languageName, const std::atomic<bool>& cancelled) {
 	using namespace Windows;
-	setLanguageToRegistry(languageName);
 	auto fileName = concatenatePath(ra3Path, L"Launcher\\" + languageName + L".csf");
-	auto csfContent = readEntireFile<char>(createFile(fileName, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING).get());
-	auto strings = loadCSFStrings(std::begin(csfContent), std::end(csfContent));
-	return {languageName, strings};
+	auto source = findAllMatchingFilesWithInformation(fileName);
+	auto cacheFileName = std::wstring{};
+	try {
+		cacheFileName = getLanguageCacheFileName(languageName);
+	}
+	catch(...) { } //language can still be loaded without cache
+
+	auto canUseCache = (source.size() == 1) and not cacheFileName.empty();
+	if(canUseCache) {
+		if(auto cached = loadLanguageCache(cacheFileName, source.front())) {
+			return cached;
+		}
+	}
+	if(cancelled) {
+		return std::nullopt;
+	}
+	auto csf = mapFile(createFile(fileName, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING).get());
+	auto table = CSFStringTable{std::move(csf)};
+	if(cancelled) {
+		return std::nullopt;
+	}
+	if(canUseCache) {
+		saveLanguageCache(cacheFileName, source.front(), table);
+	}
+	return table;
 }
 
+inline CSFStringTable loadLanguageTable(const std::wstring& ra3Path, const std::wstring& languageName) {
+	auto notCancelled = std::atomic<bool>{false};
+	return loadLanguageTable(ra3Path, languageName, notCancelled).value();
+}
+
+inline LanguageData loadLanguageData(const std::wstring& ra3Path, const std::wstring& languageName) {
+	setLanguageToRegistry(languageName);
+	return {languageName, loadLanguageTable(ra3Path, languageName)};
+}
+
+//Lists and loads every language pack on a background thread, language packs are loaded in parallel.
+//Results are only waited for if they are not ready yet, so the language picker doesn't need to wait for file I/O.
+class LanguagePreloader {
+	public:
+		explicit LanguagePreloader(std::wstring ra3Path) : ra3Path{std::move(ra3Path)} {
+			this->thread = std::thread{[this] { this->preload(); }};
+		}
+
+		LanguagePreloader(const LanguagePreloader&) = delete;
+		LanguagePreloader& operator=(const LanguagePreloader&) = delete;
+
+		~LanguagePreloader() {
+			this->stopping = true;
+			this->thread.join();
+		}
+
+		//Rethrows the exception thrown while looking for language packs
+		std::vector<std::wstring> languages() {
+			auto lock = std::unique_lock{this->mutex};
+			this->updated.wait(lock, [this] { return this->languageList.has_value() or this->languageListError; });
+			if(this->languageListError) {
+				std::rethrow_exception(this->languageListError);
+			}
+			return this->languageList.value();
+		}
+
+		//If languageName hasn't been preloaded successfully, it will be loaded by the calling thread
+		LanguageData load(const std::wstring& languageName) {
+			auto lock = std::unique_lock{this->mutex};
+			this->updated.wait(lock, [this, &languageName] {
+				return this->finished or this->tables.count(languageName) != 0;
+			});
+			auto table = this->tables.find(languageName);
+			if(table == this->tables.end()) {
+				lock.unlock();
+				return loadLanguageData(this->ra3Path, languageName);
+			}
+			auto languageData = LanguageData{languageName, table->second};
+			lock.unlock();
+			setLanguageToRegistry(languageName);
+			return languageData;
+		}
+
+	private:
+		void preload() {
+			auto languages = std::vector<std::wstring>{};
+			try {
+				languages = getAllLanguages(this->ra3Path);
+				this->publish([this, &languages] { this->languageList = languages; });
+			}
+			catch(...) {
+				this->publish([this] { this->languageListError = std::current_exception(); });
+			}
+
+			try {
+				Parallel::forEachIndex(languages.size(), Parallel::defaultThreadCount(), [this, &languages](std::size_t i) {
+					if(this->stopping) {
+						return;
+					}
+					try {
+						//a pack being loaded stops at its next step, so the destructor only waits for the current step
+						auto table = loadLanguageTable(this->ra3Path, languages[i], this->stopping);
+						if(table.has_value()) {
+							this->publish([this, &languages, &table, i] { this->tables.emplace(languages[i], std::move(table.value())); });
+						}
+					}
+					catch(...) { } //it will be loaded again by load(), which reports the error
+				});
+			}
+			catch(...) { }
+			this->publish([this] { this->finished = true; });
+		}
+
+		template<typename Function>
+		void publish(Function function) {
+			{
+				auto lock = std::lock_guard{this->mutex};
+				function();
+			}
+			this->updated.notify_all();
+		}
+
+		std::wstring ra3Path;
+		std::mutex mutex;
+		std::condition_variable updated;
+		std::optional<std::vector<std::wstring>> languageList;
+		std::exception_ptr languageListError;
+		std::map<std::wstring, CSFStringTable> tables;
+		bool finished = false;
+		std::atomic<bool> stopping{false};
+		std::thread thread; //started last, after every other member has been initialized
+};
+
 inline LanguageData loadPreferredLanguageData(const std::wstring& ra3Path) {
 	auto language = std::wstring{L"english"};
 	try {
@@ -196,6 +196,7 @@ int main() {
 		}
 
 		languageData = loadPreferredLanguageData(ra3Path);
+		resolveTexts(languageData);
 
 		auto runControlCenterWhenNeeded = [&ra3Path, &languageData](bool canRun, const std::wstring& userOptions, HBITMAP customBackground) {
 			if(not canRun) {
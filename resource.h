@@ -8,6 +8,3 @@
 #define DEFAULT_ICON    200
 #define AR_BACKGROUND   201
 #define RA3BAR_LOGO     202
-
-#define BUILTIN_ENGLISH 300
-#define BUILTIN_CHINESE 301